@@ -25,13 +25,68 @@
 #=========================================================================
 
 if ($argc < 3) {
-    fprintf(STDERR, "Expecting gif image file as first argument and format as second argument; 1=MWOSD, 2=GSOSD-serial, 3=GSOSD-hardcoded.\n");
+    fprintf(STDERR, "Expecting gif image file as first argument and format as second argument; 1=MWOSD, 2=GSOSD-serial, 3=GSOSD-hardcoded, 4=GSOSD-prebuilt (optional third argument: font effect).\n");
     exit(1);
 }
 // format 1: MWOSD format
 // format 2: GSOSD format for serial input
 // format 3: GSOSD format for hard-coded development
+// format 4: GSOSD format for hard-coded, fully processed font (FONT_PREBUILT)
 $format = $argv[2];
+$effect = ($argc > 3) ? (int)$argv[3] : 0;
+
+// Font effects, see src/font.h.
+define("FE_BORDER", 0);
+define("FE_SHADOW", 1);
+define("FE_TRANSWHITE", 2);
+define("FE_BLACKWHITE", 3);
+define("FE_INVERT", 4);
+define("FE_NONE", 5);
+
+// Pixel values, see manual.
+define("PX_BLACK", 0);	// "00" : black opaque
+define("PX_TRANS", 1);	// "01" : transparent
+define("PX_WHITE", 2);	// "10" : white opaque
+
+// Apply font effect to 12x18 pixel map of a character. This must do exactly
+// the same as font_applychar() in src/font.cpp.
+function apply_effect($px, $effect)
+{
+    $out = array();
+    for ($y = 0; $y < 18; $y++) {
+	for ($x = 0; $x < 12; $x++) {
+	    if ($px[$y][$x] == PX_WHITE) {
+		$out[$y][$x] = ($effect == FE_INVERT) ? PX_BLACK : PX_WHITE;
+		continue;
+	    }
+	    switch ($effect) {
+	    case FE_BORDER:
+		$black = ($x > 0 && $px[$y][$x - 1] == PX_WHITE)
+		    || ($x < 11 && $px[$y][$x + 1] == PX_WHITE)
+		    || ($y > 0 && $px[$y - 1][$x] == PX_WHITE)
+		    || ($y < 17 && $px[$y + 1][$x] == PX_WHITE);
+		$out[$y][$x] = $black ? PX_BLACK : PX_TRANS;
+		break;
+	    case FE_SHADOW:
+		$black = ($x > 0 && $px[$y][$x - 1] == PX_WHITE)
+		    || ($y > 0 && $px[$y - 1][$x] == PX_WHITE);
+		$out[$y][$x] = $black ? PX_BLACK : PX_TRANS;
+		break;
+	    case FE_NONE:
+	    case FE_TRANSWHITE:
+		$out[$y][$x] = PX_TRANS;
+		break;
+	    case FE_INVERT:
+		$out[$y][$x] = ($px[$y][$x] == PX_BLACK) ? PX_WHITE : PX_TRANS;
+		break;
+	    default:
+		$out[$y][$x] = PX_BLACK;
+		break;
+	    }
+	}
+    }
+    return $out;
+}
 
 $gifimg = $argv[1];
 $im = @imagecreatefromgif($gifimg);
@@ -50,6 +105,64 @@ if (imagesy($im) != 288) {
 }
 $format == 1 && printf("MAX7456\n");
 
+// Format 4 is what the firmware loads upon FONT_RESET followed by
+// FONT_EFFECT <effect>: the black border is applied to the white pixels of
+// the image, then the effect (if other than the border) on top of that.
+// Character 0 remains transparent.
+if ($format == 4) {
+    printf("/* Generated by fonts/gif2osd.php from %s. Don't edit. */\n",
+	basename($gifimg));
+    printf("#define PREBUILTFONT_EFFECT (%d)\n", $effect);
+    printf("const uint8_t PREBUILTFONT[256][54] PROGMEM = {\n");
+    for ($cy = 0; $cy < 16; $cy++) {
+	for ($cx = 0; $cx < 16; $cx++) {
+	    $num = $cy * 16 + $cx;
+	    $px = array();
+	    for ($cpy = 0; $cpy < 18; $cpy++) {
+		for ($cpx = 0; $cpx < 12; $cpx++) {
+		    $white = imagecolorat($im, $cx * 12 + $cpx,
+					  $cy * 18 + $cpy) == 0;
+		    $px[$cpy][$cpx] = $white ? PX_WHITE : PX_BLACK;
+		}
+	    }
+	    $px = apply_effect($px, $num == 0 ? FE_NONE : FE_BORDER);
+	    if ($effect != FE_BORDER) {
+		$px = apply_effect($px, $num == 0 ? FE_NONE : $effect);
+	    }
+	    $byte = 0x00;
+	    $bi = 0;
+	    $bytec = 0;
+	    for ($cpy = 0; $cpy < 18; $cpy++) {
+		for ($cpx = 0; $cpx < 12; $cpx++) {
+		    $byte |= ($px[$cpy][$cpx] << (6 - $bi));
+		    $bi += 2;
+		    if ($bi == 8) {
+			$bytec++;
+			if ($bytec == 1) {
+			    printf("    { ");
+			} else if ($bytec % 14 == 1) {
+			    printf("      ");
+			}
+			printf("0x%02X", $byte);
+			if ($bytec != 54) {
+			    printf(",");
+			} else {
+			    printf(" },\n");
+			}
+			if ($bytec % 14 == 0) {
+			    printf("\n");
+			}
+			$byte = 0x00;
+			$bi = 0;
+		    }
+		}
+	    }
+	}
+    }
+    printf("};\n");
+    exit(0);
+}
+
 $pc = 0; 	// no pixels stored yet
 $byte = 0x00;	// output byte
 $bi = 0;	// bit index in $byte
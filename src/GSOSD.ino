@@ -32,6 +32,9 @@
 #include "config.h"
 #include "sensor.h"
 #include "command.h"
+#include "font.h"
+#include "alarm.h"
+#include "task.h"
 #include "globals.h"
 #include "misc.h"
 
@@ -101,20 +104,26 @@ setup(void)
     max_setup(true);
     sensor_setup(true);
     cfg_load(true);
+    sensor_load_mah();
     Serial.begin(cfg_get_baudrate());
     max_videodetect();
     request_init1();
     show_logo();
     request_init2();
+    task_setup();
 } /* setup() */
 
 
 /*------------------------------------------------------------------------
  *  Function	: loop
  *  Purpose	: Mainloop of program.
- *  Method	: Handle requests.
- *		  Try to detect attached video signal.
- *  		  Restore image visibility if needed.
+ *  Method	: Run next due background task, see TASK_TABLE:
+ *		  try to detect attached video signal,
+ *  		  restore image visibility if needed,
+ *  		  draw sensor alarms,
+ *  		  save consumed charge now and then,
+ *  		  proceed with background font job.
+ *		  Handle requests.
  *
  *  This function is automatically called repeatably by the Arduino framework.
  *
@@ -124,22 +133,6 @@ setup(void)
 void
 loop(void)
 {
-    static unsigned long 	oldtime1 = millis();	/* old timestamp */
-    static unsigned long 	oldtime2 = millis();	/* old timestamp */
-    unsigned long 		thistime = millis();	/* current timestamp */
-
-    if (thistime - oldtime1 > cfg_get_vdetect()) {
-        max_videodetect();
-	oldtime1 = thistime;
-    }
-
-    /*
-     * The OSD seems to reset the enable bit of reg VM0 now and then.
-     * We restore it here.
-     */
-    if (thistime - oldtime2 > 100) {
-        max_enable(cfg_get_enable());
-	oldtime2 = thistime;
-    }
+    task_run();
     request();
 } /* loop() */
@@ -0,0 +1,191 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: alarm.cpp
+ *  Purpose	: Sensor alarms drawn on screen.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+#include "sensor.h"
+#include "max7456.h"
+#include "alarm.h"
+
+//Workaround for http://gcc.gnu.org/bugzilla/show_bug.cgi?id=34734
+#ifdef PROGMEM
+#undef PROGMEM
+#define PROGMEM __attribute__((section(".progmem.data")))
+#endif
+
+#define ALARMWIDTH	(10)	/* characters per alarm message */
+
+/* Sensor labels as printed on the board, in order of sensor_t. */
+const char ALARMLABELS[SENSOR_COUNT][6] PROGMEM = {
+    "VBAT1",
+    "VBAT2",
+    "RSSI",
+    "CURR"
+};
+
+/*
+ * Active alarms, two bits per sensor: bit 2n is set while sensor n is below
+ * its low threshold, bit 2n+1 while it is above its high threshold. These
+ * are evaluated by the sensor task, see alarm_tick(), and drawn by the
+ * alarm task, see alarm_task().
+ */
+static uint8_t	alarms;
+
+
+/*------------------------------------------------------------------------
+ *  Function	: alarm_tick
+ *  Purpose	: Evaluate alarm thresholds of all sensors.
+ *  Method	: Compare voltages with thresholds, use hysteresis to clear.
+ *
+ *  A threshold of 0 disables the alarm. An alarm is set when the voltage
+ *  crosses the threshold and is cleared when it has come back at least
+ *  ALARMHYST mV.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+alarm_tick(
+    const int32_t	*mv)	/* voltages of all sensors in mV */
+{
+    uint16_t	lo;		/* low threshold */
+    uint16_t	hi;		/* high threshold */
+    uint16_t	hyst;		/* hysteresis */
+    uint8_t	state;		/* new alarm state */
+    uint8_t	bit;		/* low alarm bit of sensor */
+
+    hyst = cfg_get_alarmhyst();
+    state = alarms;
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+	switch (i) {
+	case SENSOR0:
+	    lo = cfg_get_alarmlo0();
+	    hi = cfg_get_alarmhi0();
+	    break;
+	case SENSOR1:
+	    lo = cfg_get_alarmlo1();
+	    hi = cfg_get_alarmhi1();
+	    break;
+	case SENSOR2:
+	    lo = cfg_get_alarmlo2();
+	    hi = cfg_get_alarmhi2();
+	    break;
+	default:
+	    lo = cfg_get_alarmlo3();
+	    hi = cfg_get_alarmhi3();
+	    break;
+	}
+	bit = 0x01 << (2 * i);
+	if (lo == 0 || mv[i] >= (int32_t)lo + hyst) {
+	    state &= ~bit;
+	} else if (mv[i] < lo) {
+	    state |= bit;
+	}
+	bit <<= 1;
+	if (hi == 0 || mv[i] <= (int32_t)hi - hyst) {
+	    state &= ~bit;
+	} else if (mv[i] > hi) {
+	    state |= bit;
+	}
+    }
+    alarms = state;
+} /* alarm_tick() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: alarm_get
+ *  Purpose	: Get active alarms.
+ *  Method	: Return state evaluated by alarm_tick().
+ *
+ *  Returns	: Bit mask of active alarms.
+ *------------------------------------------------------------------------
+ */
+uint8_t
+alarm_get(void)
+{
+    return alarms;
+} /* alarm_get() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: alarm_task
+ *  Purpose	: Draw active alarms on screen.
+ *  Method	: Clear messages drawn before if changed, draw a blinking
+ *  		  message per active alarm on consecutive rows.
+ *
+ *  Messages are drawn at position ALARMX, ALARMY and below, overwriting any
+ *  other screen contents. Characters are only set when they differ from the
+ *  shadow screenbuffer, so calling this often costs little screen refresh.
+ *  This also restores messages after clearing the screen.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+alarm_task(void)
+{
+    static uint8_t	drawn;		/* number of messages drawn */
+    static uint8_t	drawnx;		/* x-position of messages drawn */
+    static uint8_t	drawny;		/* y-position of messages drawn */
+    uint8_t		state;		/* active alarms */
+    uint8_t		x;		/* x-position */
+    uint8_t		y;		/* y-position */
+    uint8_t		n = 0;		/* number of messages */
+    uint16_t		pos;		/* screenbuf position */
+    char		buf[ALARMWIDTH + 1];/* message */
+    uint8_t		len;		/* message length */
+
+    state = alarms;
+    x = cfg_get_alarmx();
+    y = cfg_get_alarmy();
+    for (uint8_t i = 0; i < 2 * SENSOR_COUNT; i++) {
+	if ((state & (0x01 << i)) == 0) continue;
+	strlcpy_P(buf, ALARMLABELS[i / 2], sizeof(buf));
+	strcat(buf, (i % 2) == 0 ? " LOW" : " HIGH");
+	len = strlen(buf);
+	if (y + n >= screenbuf.rows) break;
+	for (uint8_t c = 0; c < ALARMWIDTH && x + c < screenbuf.cols; c++) {
+	    char ch = c < len ? buf[c] : 0x00;	/* 0x00 acts as empty */
+
+	    pos = (y + n) * screenbuf.cols + x + c;
+	    SCREENUPDATEATTR(screenbuf, pos, ch, ATTR_BLINK);
+	}
+	n++;
+    }
+
+    /* Clear messages drawn before, except where just drawn. */
+    for (uint8_t r = drawny; r < drawny + drawn && r < screenbuf.rows; r++) {
+	for (uint8_t c = drawnx;
+	     c < drawnx + ALARMWIDTH && c < screenbuf.cols; c++) {
+	    if (r >= y && r < y + n && c >= x && c < x + ALARMWIDTH) continue;
+	    SCREENUPDATE(screenbuf, r * screenbuf.cols + c, 0x00);
+	}
+    }
+    drawn = n;
+    drawnx = x;
+    drawny = y;
+} /* alarm_task() */
@@ -0,0 +1,36 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: alarm.h
+ *  Purpose	: Declarations for sensor alarms.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#ifndef ALARM_H
+#define ALARM_H
+
+void alarm_tick(const int32_t *);
+
+void alarm_task(void);
+
+uint8_t alarm_get(void);
+
+#endif /* ALARM_H */
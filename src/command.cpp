@@ -33,7 +33,13 @@
 #include "sensor.h"
 #include "config.h"
 #include "font.h"
+#include "alarm.h"
+#include "task.h"
+#include "widget.h"
+#include "tile.h"
+#include "horizon.h"
 #include "globals.h"
+#include "misc.h"
 #include "command.h"
 
 //Workaround for http://gcc.gnu.org/bugzilla/show_bug.cgi?id=34734
@@ -67,8 +73,10 @@ const char * const CMD_NAMES[] PROGMEM = {
 #undef X
 };
 
-/* X-macro generating command property matrix. */
-cmdprops_t CMD_PROPS[] = {
+#ifndef STANDALONE
+/* X-macro generating command property matrix, kept in flash. Only serial
+ * requests use it, so standalone leaves it out and unused commands go. */
+const cmdprops_t CMD_PROPS[] PROGMEM = {
 #define X(key, name, func, nargs, data) { func, nargs, data },
     COMMAND_TABLE
 #undef X
@@ -81,6 +89,10 @@ cmdprops_t CMD_PROPS[] = {
     CONFIG_TABLE1
 #undef X
 };
+#endif
+
+/* Attributes of printed data, see cmd_set_style(). */
+static uint8_t style = ATTR_NORMAL;
 
 
 #if 1
@@ -234,7 +246,7 @@ draw_borders(
 /*------------------------------------------------------------------------
  *  Function	: print_raw
  *  Purpose	: Print raw data at pos to shadow screen buffer.
- *  Method	: Use SCREENSET macro.
+ *  Method	: Use SCREENUPDATEATTR macro with current style.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
@@ -255,7 +267,7 @@ print_raw(
 	if (x >= screenbuf.cols) {
 	    break; 	/* silently abort */
 	}
-	SCREENSET(screenbuf, y * screenbuf.cols + x, data[j]);
+	SCREENUPDATEATTR(screenbuf, y * screenbuf.cols + x, data[j], style);
     }
     return true;
 } /* print_raw() */
@@ -303,7 +315,7 @@ cmd_about(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-        Serial.print("<about>");
+        Serial.print(F("<about>"));
     }
 #endif
     if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
@@ -311,9 +323,9 @@ cmd_about(
 	stx = true;
     }
     Serial.println();
-    Serial.print("This is GS-OSD, version: ");
+    Serial.print(F("This is GS-OSD, version: "));
     Serial.println(cfg_get_version());
-    Serial.println("For more info, visit: https://github.com/Martin7182/GSOSD");
+    Serial.println(F("For more info, visit: https://github.com/Martin7182/GSOSD"));
     if (stx) {
         Serial.write((byte)CONTROL_ETX);
     }
@@ -321,6 +333,7 @@ cmd_about(
 } /* cmd_about() */
 
 
+#ifndef STANDALONE
 /*------------------------------------------------------------------------
  *  Function	: cmd_list
  *  Purpose	: List all commands.
@@ -337,13 +350,13 @@ cmd_list(
 #define NAME "name         "
 #define NAMELEN sizeof(NAME)
 
-    cmdprops_p 	cmdprops;	/* command properties */
+    cmdprops_t 	cmdprops;	/* command properties */
     char 	buf[CMD_SIZE];	/* buffer for PROGMEM strings */
     bool 	stx = false; 	/* whether STX printed */
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-        Serial.print("<list>");
+        Serial.print(F("<list>"));
     }
 #endif
 
@@ -352,17 +365,17 @@ cmd_list(
 	stx = true;
     }
     Serial.println();
-    Serial.print("number");
+    Serial.print(F("number"));
     Serial.print('\t');
-    Serial.print(NAME);
+    Serial.print(F(NAME));
     Serial.print('\t');
-    Serial.print("argc");
+    Serial.print(F("argc"));
     Serial.print('\t');
-    Serial.print("use_data");
+    Serial.print(F("use_data"));
     Serial.println();
     for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
 	strlcpy_P(buf, (char *)pgm_read_word(&(CMD_NAMES[i])), sizeof(buf));
-	cmdprops = &CMD_PROPS[i];
+	memcpy_P(&cmdprops, &CMD_PROPS[i], sizeof(cmdprops));
 	Serial.print(i);
 	Serial.print('\t');
 	Serial.print(buf);
@@ -370,9 +383,9 @@ cmd_list(
 	    Serial.print(' ');
 	}
 	Serial.print('\t');
-	Serial.print(cmdprops->argc);
+	Serial.print(cmdprops.argc);
 	Serial.print('\t');
-	Serial.print(cmdprops->use_data ? "true" : "false");
+	Serial.print(cmdprops.use_data ? F("true") : F("false"));
 	Serial.println();
     }
     if (stx) {
@@ -380,6 +393,7 @@ cmd_list(
     }
     return true;
 } /* cmd_list() */
+#endif
 
 
 /*------------------------------------------------------------------------
@@ -397,7 +411,7 @@ cmd_reset(
 {
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-        Serial.print("<reset>");
+        Serial.print(F("<reset>"));
     }
 #endif
 
@@ -429,16 +443,16 @@ cmd_clearpart(
     h = args[3];
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<clearpart");
-	Serial.print(" x=");
+	Serial.print(F("<clearpart"));
+	Serial.print(F(" x="));
 	Serial.print(x);
-	Serial.print(" y=");
+	Serial.print(F(" y="));
 	Serial.print(y);
-	Serial.print(" w=");
+	Serial.print(F(" w="));
 	Serial.print(w);
-	Serial.print(" h=");
+	Serial.print(F(" h="));
 	Serial.print(h);
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
@@ -477,14 +491,14 @@ cmd_clear(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<clear>");
+	Serial.print(F("<clear>"));
     }
 #endif
 
     pos = screenbuf.cols * screenbuf.rows;
     do {
 	pos--;
-	SCREENSET(screenbuf, pos, 0x00); /* 0x00 acts as empty value */
+	SCREENUPDATE(screenbuf, pos, 0x00); /* 0x00 acts as empty value */
     } while (pos > 0);
     return true;
 } /* cmd_clear() */
@@ -505,7 +519,7 @@ cmd_dump(
 {
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-        Serial.print("<dump>");
+        Serial.print(F("<dump>"));
     }
 #endif
 
@@ -528,7 +542,7 @@ cmd_load(
 {
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-        Serial.print("<load>");
+        Serial.print(F("<load>"));
     }
 #endif
 
@@ -551,7 +565,7 @@ cmd_defaults(
 {
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-        Serial.print("<defaults>");
+        Serial.print(F("<defaults>"));
     }
 #endif
 
@@ -575,7 +589,7 @@ cmd_save(
 {
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-        Serial.print("<save>");
+        Serial.print(F("<save>"));
     }
 #endif
 
@@ -604,10 +618,10 @@ cmd_hos(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<hos");
-	Serial.print(" num=");
+	Serial.print(F("<hos"));
+	Serial.print(F(" num="));
 	Serial.print(num);
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
@@ -637,10 +651,10 @@ cmd_vos(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<vos");
-	Serial.print(" num=");
+	Serial.print(F("<vos"));
+	Serial.print(F(" num="));
 	Serial.print(num);
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
@@ -671,10 +685,10 @@ cmd_insmux1(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<insmux1");
-	Serial.print(" num=");
+	Serial.print(F("<insmux1"));
+	Serial.print(F(" num="));
 	Serial.print(num);
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
@@ -705,10 +719,10 @@ cmd_insmux2(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<insmux2");
-	Serial.print(" num=");
+	Serial.print(F("<insmux2"));
+	Serial.print(F(" num="));
 	Serial.print(num);
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
@@ -740,12 +754,12 @@ cmd_cbl(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<cbl");
-	Serial.print(" line=");
+	Serial.print(F("<cbl"));
+	Serial.print(F(" line="));
 	Serial.print(num);
-	Serial.print(" num=");
+	Serial.print(F(" num="));
 	Serial.print(num);
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
@@ -777,12 +791,12 @@ cmd_cwl(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<cwl");
-	Serial.print(" line=");
+	Serial.print(F("<cwl"));
+	Serial.print(F(" line="));
 	Serial.print(num);
-	Serial.print(" num=");
+	Serial.print(F(" num="));
 	Serial.print(num);
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
@@ -791,6 +805,81 @@ cmd_cwl(
 } /* cmd_cwl() */
 
 
+/*------------------------------------------------------------------------
+ *  Function	: cmd_row_level
+ *  Purpose	: Set Character Black/White Level of a range of rows.
+ *  Method	: Call max_rowlevel() with equal levels for first and last row.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_row_level(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<row_level"));
+	Serial.print(F(" first="));
+	Serial.print(args[0]);
+	Serial.print(F(" last="));
+	Serial.print(args[1]);
+	Serial.print(F(" black="));
+	Serial.print(args[2]);
+	Serial.print(F(" white="));
+	Serial.print(args[3]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return max_rowlevel(args[0], args[1], args[2], args[3], args[2], args[3]);
+} /* cmd_row_level() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_row_fade
+ *  Purpose	: Fade Character Black/White Level over a range of rows.
+ *  Method	: Split register values into levels, call max_rowlevel().
+ *
+ *  The levels of the first and last row are given as Row N Brightness
+ *  register values: black level * 4 + white level.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_row_fade(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int16_t	from;	/* register value at first row */
+    int16_t	to;	/* register value at last row */
+
+    from = args[2];
+    to = args[3];
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<row_fade"));
+	Serial.print(F(" first="));
+	Serial.print(args[0]);
+	Serial.print(F(" last="));
+	Serial.print(args[1]);
+	Serial.print(F(" from="));
+	Serial.print(from);
+	Serial.print(F(" to="));
+	Serial.print(to);
+	Serial.print(F(">"));
+    }
+#endif
+
+    if (from < 0 || from > 0x0F || to < 0 || to > 0x0F) return false;
+    return max_rowlevel(args[0], args[1], from >> 2, from & 0x03,
+			to >> 2, to & 0x03);
+} /* cmd_row_fade() */
+
+
 /*------------------------------------------------------------------------
  *  Function	: cmd_p_raw
  *  Purpose	: Print raw data from serial connection.
@@ -822,26 +911,26 @@ cmd_p_raw(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<p_raw");
-	Serial.print(" x=");
+	Serial.print(F("<p_raw"));
+	Serial.print(F(" x="));
 	Serial.print(x);
-	Serial.print(" y=");
+	Serial.print(F(" y="));
 	Serial.print(y);
-	Serial.print(" i=");
+	Serial.print(F(" i="));
 	Serial.print(i);
-	Serial.print(" len=");
+	Serial.print(F(" len="));
 	Serial.print(len);
-	Serial.print(" data=");
+	Serial.print(F(" data="));
 	for (int j = 0; j < len; j++) {
             char ch;	/* data character */
 	    if (isprint(ch = data[j])) {
 		Serial.write(ch);
 	    } else {
-		Serial.print("\\0x");
+		Serial.print(F("\\0x"));
 		Serial.print(ch, HEX);
 	    }
 	}
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
@@ -851,163 +940,136 @@ cmd_p_raw(
 
 
 /*------------------------------------------------------------------------
- *  Function	: cmd_p_window
- *  Purpose	: Print interpreted data from serial connection to window.
- *  Method	: Use SCREENSET macro.
+ *  Function	: cmd_p_attr
+ *  Purpose	: Set attributes of characters on screen.
+ *  Method	: Update attributes in shadow screen buffer, keep characters.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
 bool
-cmd_p_window(
+cmd_p_attr(
     int32_t 	*args,	/* integer arguments */
 		...)	/* data arguments */
 {
     int16_t	x;	/* X-coordinate */
     int16_t	y;	/* Y-coordinate */
-    int16_t	w;	/* width; negative means with left & right border */
-    int16_t	h;	/* height negative means with top & bottom border */
-    int		i;	/* num of bytes processed in earlier calls */
-    int		len;	/* data length in bytes */
-    const char	*data;	/* data to process */
-    va_list	ap;	/* va_list handle */
-    int8_t 	xw;	/* X-coordinate of window position */
-    int8_t 	yw;	/* Y-coordinate of window position */
-    int 	j;	/* loop counter  */
+    int16_t	len;	/* number of characters */
+    int16_t	attr;	/* attributes */
+    uint16_t	pos;	/* screen buffer position */
 
     x = args[0];
     y = args[1];
-    w = args[2];
-    h = args[3];
-    va_start(ap, args);
-    i = va_arg(ap, int);
-    len = va_arg(ap, int);
-    data = va_arg(ap, const char *);
-    va_end(ap);
+    len = args[2];
+    attr = args[3];
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<p_window");
-	Serial.print(" x=");
+	Serial.print(F("<p_attr"));
+	Serial.print(F(" x="));
 	Serial.print(x);
-	Serial.print(" y=");
+	Serial.print(F(" y="));
 	Serial.print(y);
-	Serial.print(" w=");
-	Serial.print(w);
-	Serial.print(" h=");
-	Serial.print(h);
-	Serial.print(" i=");
-	Serial.print(i);
-	Serial.print(" len=");
+	Serial.print(F(" len="));
 	Serial.print(len);
-	Serial.print(" data=");
-	for (j = 0; j < len; j++) {
-            char ch;	/* data character */
-	    if (isprint(ch = data[j])) {
-		Serial.write(ch);
-	    } else {
-		Serial.print("\\0x");
-		Serial.print(ch, HEX);
-	    }
-	}
-	Serial.print(">");
+	Serial.print(F(" attr="));
+	Serial.print(attr);
+	Serial.print(F(">"));
     }
 #endif
 
-    if (y < 0 || x < 0 || w == 0 || h == 0
-        || y + abs(h) > screenbuf.rows || x + abs(w) > screenbuf.cols) {
+    if (y < 0 || x < 0 || y >= screenbuf.rows || x >= screenbuf.cols) {
 	return false;	/* obviously wrong */
     }
-
-    if (i == 0) {
-	draw_borders(x, y, w, h);
+    if (attr < 0 || attr > ATTR_MASK) return false;
+    if (len < 0 || len > screenbuf.cols - x) len = screenbuf.cols - x;
+    for (pos = y * screenbuf.cols + x; len > 0; len--, pos++) {
+	SCREENUPDATEATTR(screenbuf, pos, screenbuf.buf[pos], attr);
     }
-    w = abs(w);
-    h = abs(h);
+    return true;
+} /* cmd_p_attr() */
 
-    /*
-     * Get first empty position.
-     * Scan last column top to bottom.
-     */
-    yw = y;
-    xw = x + w - 1;
-    while (yw < y + h && screenbuf.buf[yw * screenbuf.cols + xw]) {
-	yw++;
-    }
-    if (yw < y + h) {
-	/*
-	 * At least lower right is empty.
-	 * Scan current row left to right.
-	 */
-	xw = x;
-	while (screenbuf.buf[yw * screenbuf.cols + xw]) {
-	    xw++;
-	}
-    }
 
-    for (j = 0; j < len; j++) {
-	if (yw == y + h) {
-	    /* scroll up */
-	    for (yw = y; yw < y + h - 1; yw++) {
-	        for (xw = x; xw < x + w; xw++) {
-		    SCREENSET(screenbuf, yw * screenbuf.cols + xw,
-		              screenbuf.buf[(yw + 1) * screenbuf.cols + xw]);
-	        }
-	    }
-	    for (xw = x; xw < x + w; xw++) {
-	        SCREENSET(screenbuf, yw * screenbuf.cols + xw, 0x00);
-	    }
-	    yw = y + h - 1;
-	    xw = x;
-	}
-	if (data[j] == 0x0D) {
-	    /* newline, fill rest of line with spaces */
-	    while (xw < x + w) {
-	        SCREENSET(screenbuf, yw * screenbuf.cols + xw, ' ');
-	        xw++;
-	    }
-	    yw++;
-	    xw = x;
-	} else {
-	    SCREENSET(screenbuf, yw * screenbuf.cols + xw, data[j]);
-	    if (++xw == x + w) {
-		yw++;
-		xw = x;
-	    }
-	}
+/*------------------------------------------------------------------------
+ *  Function	: cmd_set_style
+ *  Purpose	: Set attributes of data printed hereafter.
+ *  Method	: Store attributes for print commands.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_set_style(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<set_style"));
+	Serial.print(F(" attr="));
+	Serial.print(args[0]);
+	Serial.print(F(">"));
     }
+#endif
+
+    if (args[0] < 0 || args[0] > ATTR_MASK) return false;
+    style = args[0];
     return true;
-} /* cmd_p_window() */
+} /* cmd_set_style() */
 
 
 /*------------------------------------------------------------------------
- *  Function	: cmd_p_banner
- *  Purpose	: Print raw data from serial connection as rolling banner.
- *  Method	: Use SCREENSET macro.
+ *  Function	: cmd_field_def
+ *  Purpose	: Define a field formatted by the OSD.
+ *  Method	: Call widget_def().
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
 bool
-cmd_p_banner(
+cmd_field_def(
     int32_t 	*args,	/* integer arguments */
 		...)	/* data arguments */
 {
-    int16_t	x;	/* X-coordinate */
-    int16_t	y;	/* Y-coordinate */
-    int16_t	w;	/* width */
-    int16_t	h;	/* height */
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<field_def"));
+	Serial.print(F(" id="));
+	Serial.print(args[0]);
+	Serial.print(F(" x="));
+	Serial.print(args[1]);
+	Serial.print(F(" y="));
+	Serial.print(args[2]);
+	Serial.print(F(" format="));
+	Serial.print(args[3]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return widget_def(args[0], args[1], args[2], args[3]);
+} /* cmd_field_def() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_field_suffix
+ *  Purpose	: Set the text after the value of a field.
+ *  Method	: Call widget_suffix().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_field_suffix(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int16_t	id;	/* field id */
     int		i;	/* num of bytes processed in earlier calls */
     int		len;	/* data length in bytes */
     const char	*data;	/* data to process */
     va_list	ap;	/* va_list handle */
-    int8_t 	xw;	/* X-coordinate of window position */
-    int8_t 	yw;	/* Y-coordinate of window position */
 
-    x = args[0];
-    y = args[1];
-    w = args[2];
-    h = args[3];
+    id = args[0];
     va_start(ap, args);
     i = va_arg(ap, int);
     len = va_arg(ap, int);
@@ -1016,359 +1078,1265 @@ cmd_p_banner(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<p_banner");
-	Serial.print(" x=");
-	Serial.print(x);
-	Serial.print(" y=");
-	Serial.print(y);
-	Serial.print(" w=");
-	Serial.print(w);
-	Serial.print(" h=");
-	Serial.print(h);
-	Serial.print(" i=");
+	Serial.print(F("<field_suffix"));
+	Serial.print(F(" id="));
+	Serial.print(id);
+	Serial.print(F(" i="));
 	Serial.print(i);
-	Serial.print(" len=");
+	Serial.print(F(" len="));
 	Serial.print(len);
-	Serial.print(" data=");
-	for (int j = 0; j < len; j++) {
-            char ch;	/* data character */
-	    if (isprint(ch = data[j])) {
-		Serial.write(ch);
-	    } else {
-		Serial.print("\\0x");
-		Serial.print(ch, HEX);
-	    }
-	}
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
-    if (y < 0 || x < 0 || w == 0 || h == 0
-        || y + abs(h) > screenbuf.rows || x + abs(w) > screenbuf.cols) {
-	return false;	/* obviously wrong */
-    }
-
-    if (i == 0) {
-	draw_borders(x, y, w, h);
-    }
-    w = abs(w);
-    h = abs(h);
-
-    /*
-     * Get first empty position. As a banner, likely all space is occupied;
-     * scan backwards for first filled position, for performance.
-     */
-    yw = y + h - 1;
-    xw = 0;
-    while (yw >= y) {
-        xw = x + w - 1;
-	while (xw >= x && !screenbuf.buf[yw * screenbuf.cols + xw]) {
-	    xw--;
-	}
-	if (xw >= x) {
-	    /* filled position found */
-	    if (xw == x + w - 1) {
-		/* at last pos of current line */
-		if (++yw == y + h) {
-		    /* at last line */
-		    xw = x + w;
-		} else {
-		    /* before last line */
-		    xw = x;
-		}
-	    } else {
-		/* before last pos of current line */
-		xw++;
-	    }
-	    break;
-        }
-	/* filled position not found yet */
-	yw--;
-    }
-    if (yw < y) {
-	/* filled position not found */
-        yw = y;
-        xw = x;
-    }
-
-    for (int j = 0; j < len; j++) {
-	if (yw == y + h) {
-	    /* scroll left and possibly up */
-	    for (yw = y; yw < y + h; yw++) {
-		for (xw = x; xw < x + w - 1; xw++) {
-		    SCREENSET(screenbuf, yw * screenbuf.cols + xw,
-		              screenbuf.buf[yw * screenbuf.cols + xw + 1]);
-		}
-		/* xw = x + w - 1 */
-		if (yw < y + h - 1) {
-		    SCREENSET(screenbuf, yw * screenbuf.cols + xw,
-		              screenbuf.buf[(yw + 1) * screenbuf.cols + x]);
-		}
-	    }
-	    yw--; /* yw = y + h - 1 */
-	}
-	SCREENSET(screenbuf, yw * screenbuf.cols + xw, data[j]);
-	if (++xw == x + w) {
-	    /* current line is full, move to first position of next line */
-	    yw++;
-	    xw = x;
-	}
-    }
-
-    return true;
-} /* cmd_p_banner() */
+    return widget_suffix(id, i, len, data);
+} /* cmd_field_suffix() */
 
 
 /*------------------------------------------------------------------------
- *  Function	: cmd_font_effect
- *  Purpose	: Apply effect to current font in Max7456 chip (eeprom).
- *  Method	: Call font_apply().
+ *  Function	: cmd_set_field
+ *  Purpose	: Show a new value in a field.
+ *  Method	: Call widget_set() with current style.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
 bool
-cmd_font_effect(
-	int32_t *args,	/* integer arguments */
+cmd_set_field(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<set_field"));
+	Serial.print(F(" id="));
+	Serial.print(args[0]);
+	Serial.print(F(" value="));
+	Serial.print(args[1]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return widget_set(args[0], args[1], style);
+} /* cmd_set_field() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_bar
+ *  Purpose	: Define a bar graph.
+ *  Method	: Call widget_defbar().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_bar(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<bar"));
+	Serial.print(F(" id="));
+	Serial.print(args[0]);
+	Serial.print(F(" x="));
+	Serial.print(args[1]);
+	Serial.print(F(" y="));
+	Serial.print(args[2]);
+	Serial.print(F(" len="));
+	Serial.print(args[3]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return widget_defbar(args[0], args[1], args[2], args[3], FIELD_BAR);
+} /* cmd_bar() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_gauge
+ *  Purpose	: Define a gauge.
+ *  Method	: Call widget_defbar().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_gauge(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<gauge"));
+	Serial.print(F(" id="));
+	Serial.print(args[0]);
+	Serial.print(F(" x="));
+	Serial.print(args[1]);
+	Serial.print(F(" y="));
+	Serial.print(args[2]);
+	Serial.print(F(" len="));
+	Serial.print(args[3]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return widget_defbar(args[0], args[1], args[2], args[3], FIELD_GAUGE);
+} /* cmd_gauge() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_field_range
+ *  Purpose	: Set the value range of a bar graph or gauge.
+ *  Method	: Call widget_range().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_field_range(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<field_range"));
+	Serial.print(F(" id="));
+	Serial.print(args[0]);
+	Serial.print(F(" min="));
+	Serial.print(args[1]);
+	Serial.print(F(" max="));
+	Serial.print(args[2]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return widget_range(args[0], args[1], args[2]);
+} /* cmd_field_range() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_tile_def
+ *  Purpose	: Define a tile from serial data.
+ *  Method	: Call tile_def().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_tile_def(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int16_t	id;	/* tile id */
+    int16_t	width;	/* width in characters */
+    int16_t	height;	/* height in characters */
+    int		i;	/* num of bytes processed in earlier calls */
+    int		len;	/* data length in bytes */
+    const char	*data;	/* data to process */
+    va_list	ap;	/* va_list handle */
+
+    id = args[0];
+    width = args[1];
+    height = args[2];
+    va_start(ap, args);
+    i = va_arg(ap, int);
+    len = va_arg(ap, int);
+    data = va_arg(ap, const char *);
+    va_end(ap);
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<tile_def"));
+	Serial.print(F(" id="));
+	Serial.print(id);
+	Serial.print(F(" width="));
+	Serial.print(width);
+	Serial.print(F(" height="));
+	Serial.print(height);
+	Serial.print(F(" i="));
+	Serial.print(i);
+	Serial.print(F(" len="));
+	Serial.print(len);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return tile_def(id, width, height, i, len, data);
+} /* cmd_tile_def() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_blit
+ *  Purpose	: Show a tile on screen.
+ *  Method	: Call tile_blit() with current style.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_blit(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<blit"));
+	Serial.print(F(" id="));
+	Serial.print(args[0]);
+	Serial.print(F(" x="));
+	Serial.print(args[1]);
+	Serial.print(F(" y="));
+	Serial.print(args[2]);
+	Serial.print(F(" key="));
+	Serial.print(args[3]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return tile_blit(args[0], args[1], args[2], args[3], style);
+} /* cmd_blit() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_horizon_def
+ *  Purpose	: Define the artificial horizon area.
+ *  Method	: Call horizon_def().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_horizon_def(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<horizon_def"));
+	Serial.print(F(" x="));
+	Serial.print(args[0]);
+	Serial.print(F(" y="));
+	Serial.print(args[1]);
+	Serial.print(F(" width="));
+	Serial.print(args[2]);
+	Serial.print(F(" height="));
+	Serial.print(args[3]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return horizon_def(args[0], args[1], args[2], args[3]);
+} /* cmd_horizon_def() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_horizon
+ *  Purpose	: Show the artificial horizon for an attitude.
+ *  Method	: Call horizon_set() with current style.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_horizon(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<horizon"));
+	Serial.print(F(" roll="));
+	Serial.print(args[0]);
+	Serial.print(F(" pitch="));
+	Serial.print(args[1]);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return horizon_set(args[0], args[1], style);
+} /* cmd_horizon() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_p_window
+ *  Purpose	: Print interpreted data from serial connection to window.
+ *  Method	: Use SCREENSET macro.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_p_window(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int16_t	x;	/* X-coordinate */
+    int16_t	y;	/* Y-coordinate */
+    int16_t	w;	/* width; negative means with left & right border */
+    int16_t	h;	/* height negative means with top & bottom border */
+    int		i;	/* num of bytes processed in earlier calls */
+    int		len;	/* data length in bytes */
+    const char	*data;	/* data to process */
+    va_list	ap;	/* va_list handle */
+    int8_t 	xw;	/* X-coordinate of window position */
+    int8_t 	yw;	/* Y-coordinate of window position */
+    int 	j;	/* loop counter  */
+
+    x = args[0];
+    y = args[1];
+    w = args[2];
+    h = args[3];
+    va_start(ap, args);
+    i = va_arg(ap, int);
+    len = va_arg(ap, int);
+    data = va_arg(ap, const char *);
+    va_end(ap);
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<p_window"));
+	Serial.print(F(" x="));
+	Serial.print(x);
+	Serial.print(F(" y="));
+	Serial.print(y);
+	Serial.print(F(" w="));
+	Serial.print(w);
+	Serial.print(F(" h="));
+	Serial.print(h);
+	Serial.print(F(" i="));
+	Serial.print(i);
+	Serial.print(F(" len="));
+	Serial.print(len);
+	Serial.print(F(" data="));
+	for (j = 0; j < len; j++) {
+            char ch;	/* data character */
+	    if (isprint(ch = data[j])) {
+		Serial.write(ch);
+	    } else {
+		Serial.print(F("\\0x"));
+		Serial.print(ch, HEX);
+	    }
+	}
+	Serial.print(F(">"));
+    }
+#endif
+
+    if (y < 0 || x < 0 || w == 0 || h == 0
+        || y + abs(h) > screenbuf.rows || x + abs(w) > screenbuf.cols) {
+	return false;	/* obviously wrong */
+    }
+
+    if (i == 0) {
+	draw_borders(x, y, w, h);
+    }
+    w = abs(w);
+    h = abs(h);
+
+    /*
+     * Get first empty position.
+     * Scan last column top to bottom.
+     */
+    yw = y;
+    xw = x + w - 1;
+    while (yw < y + h && screenbuf.buf[yw * screenbuf.cols + xw]) {
+	yw++;
+    }
+    if (yw < y + h) {
+	/*
+	 * At least lower right is empty.
+	 * Scan current row left to right.
+	 */
+	xw = x;
+	while (screenbuf.buf[yw * screenbuf.cols + xw]) {
+	    xw++;
+	}
+    }
+
+    for (j = 0; j < len; j++) {
+	if (yw == y + h) {
+	    /* scroll up */
+	    for (yw = y; yw < y + h - 1; yw++) {
+	        for (xw = x; xw < x + w; xw++) {
+		    SCREENSETATTR(screenbuf, yw * screenbuf.cols + xw,
+		        screenbuf.buf[(yw + 1) * screenbuf.cols + xw],
+		        SCREENATTR(screenbuf, (yw + 1) * screenbuf.cols + xw));
+	        }
+	    }
+	    for (xw = x; xw < x + w; xw++) {
+	        SCREENSET(screenbuf, yw * screenbuf.cols + xw, 0x00);
+	    }
+	    yw = y + h - 1;
+	    xw = x;
+	}
+	if (data[j] == 0x0D) {
+	    /* newline, fill rest of line with spaces */
+	    while (xw < x + w) {
+	        SCREENSETATTR(screenbuf, yw * screenbuf.cols + xw, ' ', style);
+	        xw++;
+	    }
+	    yw++;
+	    xw = x;
+	} else {
+	    SCREENSETATTR(screenbuf, yw * screenbuf.cols + xw, data[j], style);
+	    if (++xw == x + w) {
+		yw++;
+		xw = x;
+	    }
+	}
+    }
+    return true;
+} /* cmd_p_window() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_p_banner
+ *  Purpose	: Print raw data from serial connection as rolling banner.
+ *  Method	: Use SCREENSET macro.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_p_banner(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int16_t	x;	/* X-coordinate */
+    int16_t	y;	/* Y-coordinate */
+    int16_t	w;	/* width */
+    int16_t	h;	/* height */
+    int		i;	/* num of bytes processed in earlier calls */
+    int		len;	/* data length in bytes */
+    const char	*data;	/* data to process */
+    va_list	ap;	/* va_list handle */
+    int8_t 	xw;	/* X-coordinate of window position */
+    int8_t 	yw;	/* Y-coordinate of window position */
+
+    x = args[0];
+    y = args[1];
+    w = args[2];
+    h = args[3];
+    va_start(ap, args);
+    i = va_arg(ap, int);
+    len = va_arg(ap, int);
+    data = va_arg(ap, const char *);
+    va_end(ap);
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<p_banner"));
+	Serial.print(F(" x="));
+	Serial.print(x);
+	Serial.print(F(" y="));
+	Serial.print(y);
+	Serial.print(F(" w="));
+	Serial.print(w);
+	Serial.print(F(" h="));
+	Serial.print(h);
+	Serial.print(F(" i="));
+	Serial.print(i);
+	Serial.print(F(" len="));
+	Serial.print(len);
+	Serial.print(F(" data="));
+	for (int j = 0; j < len; j++) {
+            char ch;	/* data character */
+	    if (isprint(ch = data[j])) {
+		Serial.write(ch);
+	    } else {
+		Serial.print(F("\\0x"));
+		Serial.print(ch, HEX);
+	    }
+	}
+	Serial.print(F(">"));
+    }
+#endif
+
+    if (y < 0 || x < 0 || w == 0 || h == 0
+        || y + abs(h) > screenbuf.rows || x + abs(w) > screenbuf.cols) {
+	return false;	/* obviously wrong */
+    }
+
+    if (i == 0) {
+	draw_borders(x, y, w, h);
+    }
+    w = abs(w);
+    h = abs(h);
+
+    /*
+     * Get first empty position. As a banner, likely all space is occupied;
+     * scan backwards for first filled position, for performance.
+     */
+    yw = y + h - 1;
+    xw = 0;
+    while (yw >= y) {
+        xw = x + w - 1;
+	while (xw >= x && !screenbuf.buf[yw * screenbuf.cols + xw]) {
+	    xw--;
+	}
+	if (xw >= x) {
+	    /* filled position found */
+	    if (xw == x + w - 1) {
+		/* at last pos of current line */
+		if (++yw == y + h) {
+		    /* at last line */
+		    xw = x + w;
+		} else {
+		    /* before last line */
+		    xw = x;
+		}
+	    } else {
+		/* before last pos of current line */
+		xw++;
+	    }
+	    break;
+        }
+	/* filled position not found yet */
+	yw--;
+    }
+    if (yw < y) {
+	/* filled position not found */
+        yw = y;
+        xw = x;
+    }
+
+    for (int j = 0; j < len; j++) {
+	if (yw == y + h) {
+	    /* scroll left and possibly up */
+	    for (yw = y; yw < y + h; yw++) {
+		for (xw = x; xw < x + w - 1; xw++) {
+		    SCREENSETATTR(screenbuf, yw * screenbuf.cols + xw,
+		        screenbuf.buf[yw * screenbuf.cols + xw + 1],
+		        SCREENATTR(screenbuf, yw * screenbuf.cols + xw + 1));
+		}
+		/* xw = x + w - 1 */
+		if (yw < y + h - 1) {
+		    SCREENSETATTR(screenbuf, yw * screenbuf.cols + xw,
+		        screenbuf.buf[(yw + 1) * screenbuf.cols + x],
+		        SCREENATTR(screenbuf, (yw + 1) * screenbuf.cols + x));
+		}
+	    }
+	    yw--; /* yw = y + h - 1 */
+	}
+	SCREENSETATTR(screenbuf, yw * screenbuf.cols + xw, data[j], style);
+	if (++xw == x + w) {
+	    /* current line is full, move to first position of next line */
+	    yw++;
+	    xw = x;
+	}
+    }
+
+    return true;
+} /* cmd_p_banner() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_font_effect
+ *  Purpose	: Apply effect to current font in Max7456 chip (eeprom).
+ *  Method	: Call font_apply(), which starts a background job.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_font_effect(
+	int32_t *args,	/* integer arguments */
+	...)		/* data arguments */
+{
+    fonteffect_t	effect;	/* font effect to apply */
+
+    effect = (fonteffect_t)args[0];
+
+#ifndef no_debug
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<font_effect"));
+	Serial.print(F(" effect="));
+	Serial.print(effect);
+	Serial.print(F(">"));
+    }
+#endif
+
+    return font_apply(&effect);
+} /* cmd_font_effect() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_font_reset
+ *  Purpose	: Load default font into Max7456 chip (eeprom).
+ *  Method	: Call font_apply(), which starts a background job.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_font_reset(
+	int32_t *args,	/* integer arguments */
+	...)		/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+        Serial.print(F("<font_reset>"));
+    }
+#endif
+
+    return font_apply(NULL);
+} /* cmd_font_reset() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_set_font
+ *  Purpose	: Put font character to Max7456 chip (eeprom).
+ *  Method	: Fill local buffer, write font character when last byte
+ *  		  received.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_set_font(
+	int32_t *args,	/* integer arguments */
 	...)		/* data arguments */
 {
-    fonteffect_t	effect;	/* font effect to apply */
+    int32_t		num;	/* number of character to set [0 .. 255] */
+    int			i;	/* num of bytes processed in earlier calls */
+    int			j;	/* loop counter */
+    int			len;	/* data length in bytes */
+    char		ch;	/* data character */
+    int8_t 		biti;	/* bit index in byte [0 .. 7]; MSB = 7 */
+    uint8_t 		bytei;	/* byte index in buf [0 .. sizeof(buf) - 1] */
+    const char		*data;	/* data to process */
+    va_list		ap;	/* va_list handle */
+    static fontbuf_t 	buf;	/* font character buffer */
+    static uint16_t	bits;	/* number of logical bits processed */
+
+    num = args[0];
+    va_start(ap, args);
+    i = va_arg(ap, int);
+    len = va_arg(ap, int);
+    data = va_arg(ap, const char *);
+    va_end(ap);
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<set_font"));
+	Serial.print(F(" num="));
+	Serial.print(num);
+	Serial.print(F(" i="));
+	Serial.print(i);
+	Serial.print(F(" len="));
+	Serial.print(len);
+	Serial.print(F(" data="));
+	for (j = 0; j < len; j++) {
+	    if (isprint(ch = data[j])) {
+		Serial.write(ch);
+	    } else {
+		Serial.print(F("\\0x"));
+		Serial.print(ch, HEX);
+	    }
+	}
+	Serial.print(F(">"));
+    }
+#endif
+
+    if (num < 0 || num > 255) {
+	return false;
+    }
+
+    if (i == 0) {
+	/* New request, finish running font job, clear static buffer. */
+	font_flush();
+        for (j = 0; j < (int)sizeof(buf); j++) {
+	    buf[j] = 0;
+	}
+	bits = 0;
+    }
+    for (j = 0; j < len; j++) {
+	ch = data[j];
+	if (isspace(ch)) continue;			/* skip white space */
+	if (ch != '0' && ch != '1') return false;	/* unexpected data */
+	bytei = bits / 8;
+	if (bytei >= sizeof(buf)) {
+	    return false; 				/* internal error */
+	}
+
+	/*
+	 * Communication is done human readable; all logical bits are
+	 * sent using bytes '0' and '1'. All logical bytes are sent
+	 * over the line with MSB first.
+	 */
+	biti = 7 - bits % 8;
+	if (ch == '1') {
+	    buf[bytei] |= (0x01 << biti);
+	}
+        if (++bits == 8 * sizeof(buf)) {
+	    /* Last bit received, execute. */
+	    return max_fontcharput((uint8_t)num, &buf);
+	}
+    }
+    return true;
+} /* cmd_set_font() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_get_font
+ *  Purpose	: Get font character from Max7456 chip (eeprom).
+ *  Method	: Read font character into buffer, print buffer contents.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_get_font(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int32_t	num;		/* number of char to get [0 .. 255] */
+    fontbuf_t 	buf;		/* font character buffer */
+    bool 	stx = false; 	/* whether STX printed */
+
+    num = args[0];
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<get_font"));
+	Serial.print(F(" num="));
+	Serial.print(num);
+	Serial.print(F(">"));
+    }
+#endif
+
+    if (num < 0 || num > 255) {
+	return false;
+    }
+
+    font_flush();
+    if(!max_fontcharget((uint8_t)num, &buf)) {
+	return false;
+    }
+    if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
+        Serial.write((byte)CONTROL_STX);
+	stx = true;
+    }
+    for (uint8_t bytei = 0; bytei < sizeof(buf); bytei++) {
+        for (int8_t biti = 7; biti >= 0; biti--) {
+
+	    /*
+	     * Communication is done human readable; all logical bits are
+	     * sent using bytes '0' and '1'. All logical bytes are sent
+	     * over the line with MSB first.
+	     */
+	    if ((buf[bytei] & (0x01 << biti)) != 0) {
+                Serial.print(F("1"));
+	    } else {
+                Serial.print(F("0"));
+	    }
+        }
+        Serial.print(F(" "));
+    }
+    if (stx) {
+        Serial.write((byte)CONTROL_ETX);
+    }
+    return true;
+} /* cmd_get_font() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_font_status
+ *  Purpose	: Get progress of running FONT_RESET or FONT_EFFECT.
+ *  Method	: Write number of font characters still to process and
+ *  		  number of characters that failed to serial.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_font_status(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    bool stx = false; 	/* whether STX printed */
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<font_status>"));
+    }
+#endif
+    if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
+        Serial.write((byte)CONTROL_STX);
+	stx = true;
+    }
+    Serial.print(font_pending());
+    Serial.write(' ');
+    Serial.print(font_failed());
+    if (stx) {
+        Serial.write((byte)CONTROL_ETX);
+    }
+    return true;
+} /* cmd_font_status() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_font_crc
+ *  Purpose	: Get CRC32 checksum of a range of font characters.
+ *  Method	: Finish running font job, call font_crc32(), write checksum
+ *  		  as 8 hex digits to serial.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_font_crc(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int32_t	first;		/* first character of range */
+    int32_t	last;		/* last character of range */
+    uint32_t	crc;		/* checksum */
+    bool 	stx = false; 	/* whether STX printed */
+
+    first = args[0];
+    last = args[1];
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<font_crc"));
+	Serial.print(F(" first="));
+	Serial.print(first);
+	Serial.print(F(" last="));
+	Serial.print(last);
+	Serial.print(F(">"));
+    }
+#endif
+
+    if (first < 0 || last > 255 || first > last) {
+	return false;
+    }
+    font_flush();
+    if (!font_crc32((uint8_t)first, (uint8_t)last, &crc)) {
+	return false;
+    }
+    if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
+        Serial.write((byte)CONTROL_STX);
+	stx = true;
+    }
+    for (int8_t shift = 28; shift >= 0; shift -= 4) {
+	Serial.print((uint8_t)((crc >> shift) & 0x0F), HEX);
+    }
+    if (stx) {
+        Serial.write((byte)CONTROL_ETX);
+    }
+    return true;
+} /* cmd_font_crc() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_get_sensor
+ *  Purpose	: Get analogue sensor value.
+ *  Method	: Call sensor_get_mv() and serial write value in volts.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_get_sensor(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int16_t	id;		/* sensor id */
+    int32_t	mv;		/* sensor value in mV */
+    char	buf[12];	/* print buffer */
+    bool 	stx = false; 	/* whether STX printed */
 
-    effect = (fonteffect_t)args[0];
+    id = args[0];
 
-#ifndef no_debug
+#ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<font_effect");
-	Serial.print(" effect=");
-	Serial.print(effect);
-	Serial.print(">");
+	Serial.print(F("<get_sensor"));
+	Serial.print(F(" id="));
+	Serial.print(id);
+	Serial.print(F(">"));
     }
 #endif
 
-    return font_apply(&effect);
-} /* cmd_font_effect() */
+    if ((mv = sensor_get_mv((sensor_t)id)) < 0) {
+	return false;
+    }
+    if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
+        Serial.write((byte)CONTROL_STX);
+	stx = true;
+    }
+    Serial.print(fixtostrf((mv + 5) / 10, 0, 2, buf));
+    if (stx) {
+        Serial.write((byte)CONTROL_ETX);
+    }
+    return true;
+} /* cmd_get_sensor() */
 
 
 /*------------------------------------------------------------------------
- *  Function	: cmd_font_reset
- *  Purpose	: Load default font into Max7456 chip (eeprom).
- *  Method	: Call font_apply().
+ *  Function	: cmd_get_mah
+ *  Purpose	: Get consumed or remaining charge.
+ *  Method	: Write to serial.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
 bool
-cmd_font_reset(
-	int32_t *args,	/* integer arguments */
-	...)		/* data arguments */
+cmd_get_mah(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
 {
+    int16_t	id;		/* 0: consumed, 1: remaining */
+    int32_t	mah;		/* charge in mAh */
+    bool 	stx = false; 	/* whether STX printed */
+
+    id = args[0];
+
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-        Serial.print("<font_reset>");
+	Serial.print(F("<get_mah"));
+	Serial.print(F(" id="));
+	Serial.print(id);
+	Serial.print(F(">"));
     }
 #endif
 
-    return font_apply(NULL);
-} /* cmd_font_reset() */
+    if (id < 0 || id > 1 || (mah = sensor_get_mah(id == 1)) < 0) {
+	return false;
+    }
+    if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
+        Serial.write((byte)CONTROL_STX);
+	stx = true;
+    }
+    Serial.print(mah);
+    if (stx) {
+        Serial.write((byte)CONTROL_ETX);
+    }
+    return true;
+} /* cmd_get_mah() */
 
 
 /*------------------------------------------------------------------------
- *  Function	: cmd_set_font
- *  Purpose	: Put font character to Max7456 chip (eeprom).
- *  Method	: Fill local buffer, write font character when last byte
- *  		  received.
+ *  Function	: cmd_reset_mah
+ *  Purpose	: Reset consumed charge.
+ *  Method	: Use sensor routine.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
 bool
-cmd_set_font(
-	int32_t *args,	/* integer arguments */
-	...)		/* data arguments */
+cmd_reset_mah(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
 {
-    int32_t		num;	/* number of character to set [0 .. 255] */
-    int			i;	/* num of bytes processed in earlier calls */
-    int			j;	/* loop counter */
-    int			len;	/* data length in bytes */
-    char		ch;	/* data character */
-    int8_t 		biti;	/* bit index in byte [0 .. 7]; MSB = 7 */
-    uint8_t 		bytei;	/* byte index in buf [0 .. sizeof(buf) - 1] */
-    const char		*data;	/* data to process */
-    va_list		ap;	/* va_list handle */
-    static fontbuf_t 	buf;	/* font character buffer */
-    static uint16_t	bits;	/* number of logical bits processed */
-
-    num = args[0];
-    va_start(ap, args);
-    i = va_arg(ap, int);
-    len = va_arg(ap, int);
-    data = va_arg(ap, const char *);
-    va_end(ap);
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<set_font");
-	Serial.print(" num=");
-	Serial.print(num);
-	Serial.print(" i=");
-	Serial.print(i);
-	Serial.print(" len=");
-	Serial.print(len);
-	Serial.print(" data=");
-	for (j = 0; j < len; j++) {
-	    if (isprint(ch = data[j])) {
-		Serial.write(ch);
-	    } else {
-		Serial.print("\\0x");
-		Serial.print(ch, HEX);
-	    }
-	}
-	Serial.print(">");
+	Serial.print(F("<reset_mah>"));
     }
 #endif
+    sensor_reset_mah();
+    return true;
+} /* cmd_reset_mah() */
 
-    if (num < 0 || num > 255) {
-	return false;
-    }
 
-    if (i == 0) {
-	/* New request, clear static buffer. */
-        for (j = 0; j < (int)sizeof(buf); j++) {
-	    buf[j] = 0;
-	}
-	bits = 0;
+/*------------------------------------------------------------------------
+ *  Function	: cmd_subscribe
+ *  Purpose	: Subscribe to periodic sensor reports.
+ *  Method	: Check arguments and use sensor routine.
+ *
+ *  Reports are written by the request handler while idle.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_subscribe(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int32_t	mask;		/* sensors to report */
+    int32_t	interval;	/* report interval in ms */
+    int32_t	deadband;	/* min. change in mV */
+
+    mask = args[0];
+    interval = args[1];
+    deadband = args[2];
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<subscribe"));
+	Serial.print(F(" mask="));
+	Serial.print(mask);
+	Serial.print(F(" interval="));
+	Serial.print(interval);
+	Serial.print(F(" deadband="));
+	Serial.print(deadband);
+	Serial.print(F(">"));
     }
-    for (j = 0; j < len; j++) {
-	ch = data[j];
-	if (isspace(ch)) continue;			/* skip white space */
-	if (ch != '0' && ch != '1') return false;	/* unexpected data */
-	bytei = bits / 8;
-	if (bytei >= sizeof(buf)) {
-	    return false; 				/* internal error */
-	}
+#endif
 
-	/*
-	 * Communication is done human readable; all logical bits are
-	 * sent using bytes '0' and '1'. All logical bytes are sent
-	 * over the line with MSB first.
-	 */
-	biti = 7 - bits % 8;
-	if (ch == '1') {
-	    buf[bytei] |= (0x01 << biti);
-	}
-        if (++bits == 8 * sizeof(buf)) {
-	    /* Last bit received, execute. */
-	    return max_fontcharput((uint8_t)num, &buf);
-	}
+    if (mask < 0 || mask > 255
+	|| interval < 0 || interval > 65535
+	|| deadband < 0 || deadband > 65535) {
+	return false;
     }
-    return true;
-} /* cmd_set_font() */
+    return sensor_subscribe(mask, interval, deadband);
+} /* cmd_subscribe() */
 
 
 /*------------------------------------------------------------------------
- *  Function	: cmd_get_font
- *  Purpose	: Get font character from Max7456 chip (eeprom).
- *  Method	: Read font character into buffer, print buffer contents.
+ *  Function	: cmd_stats
+ *  Purpose	: Get statistics of requested sensor.
+ *  Method	: Write all values in one go to serial.
+ *
+ *  The output consists of integers separated by spaces: min, max and mean
+ *  voltage in mV, sample count, history period in ms and the history
+ *  voltages in mV, oldest first.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
 bool
-cmd_get_font(
+cmd_stats(
     int32_t 	*args,	/* integer arguments */
 		...)	/* data arguments */
 {
-    int32_t	num;		/* number of char to get [0 .. 255] */
-    fontbuf_t 	buf;		/* font character buffer */
-    bool 	stx = false; 	/* whether STX printed */
+    int16_t		id;		/* sensor id */
+    sensorstats_t	st;		/* statistics */
+    uint32_t		period;		/* history period in ms */
+    uint32_t		mean;		/* mean voltage in mV */
+    int8_t		len;		/* number of history entries */
+    bool 		stx = false; 	/* whether STX printed */
 
-    num = args[0];
+    id = args[0];
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<get_font");
-	Serial.print(" num=");
-	Serial.print(num);
-	Serial.print(">");
+	Serial.print(F("<stats"));
+	Serial.print(F(" id="));
+	Serial.print(id);
+	Serial.print(F(">"));
     }
 #endif
 
-    if (num < 0 || num > 255) {
-	return false;
-    }
-
-    if(!max_fontcharget((uint8_t)num, &buf)) {
+    if ((len = sensor_get_stats((sensor_t)id, &st, &period)) < 0) {
 	return false;
     }
     if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
         Serial.write((byte)CONTROL_STX);
 	stx = true;
     }
-    for (uint8_t bytei = 0; bytei < sizeof(buf); bytei++) {
-        for (int8_t biti = 7; biti >= 0; biti--) {
-
-	    /*
-	     * Communication is done human readable; all logical bits are
-	     * sent using bytes '0' and '1'. All logical bytes are sent
-	     * over the line with MSB first.
-	     */
-	    if ((buf[bytei] & (0x01 << biti)) != 0) {
-                Serial.print("1");
-	    } else {
-                Serial.print("0");
-	    }
-        }
-        Serial.print(" ");
+    if (st.count == 0) {
+	st.min = 0;
+	st.max = 0;
+    }
+    mean = st.count ? (st.sum + st.count / 2) / st.count : 0;
+    Serial.print(st.min);
+    Serial.write(' ');
+    Serial.print(st.max);
+    Serial.write(' ');
+    Serial.print(mean);
+    Serial.write(' ');
+    Serial.print(st.count);
+    Serial.write(' ');
+    Serial.print(period);
+    for (int8_t i = 0; i < len; i++) {
+	Serial.write(' ');
+	Serial.print(st.hist[i]);
     }
     if (stx) {
         Serial.write((byte)CONTROL_ETX);
     }
     return true;
-} /* cmd_get_font() */
+} /* cmd_stats() */
 
 
 /*------------------------------------------------------------------------
- *  Function	: cmd_get_sensor
- *  Purpose	: Get analogue sensor value.
- *  Method	: Call minim_get_sensor() and serial write value.
+ *  Function	: cmd_stats_reset
+ *  Purpose	: Reset statistics of all sensors.
+ *  Method	: Use sensor routine.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
 bool
-cmd_get_sensor(
+cmd_stats_reset(
     int32_t 	*args,	/* integer arguments */
 		...)	/* data arguments */
 {
-#define EPS (-0.001)
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<stats_reset>"));
+    }
+#endif
+    sensor_reset_stats();
+    return true;
+} /* cmd_stats_reset() */
 
-    int16_t	id;		/* sensor id */
-    float	val;		/* sensor value */
-    bool 	stx = false; 	/* whether STX printed */
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_get_alarms
+ *  Purpose	: Get active sensor alarms.
+ *  Method	: Write bit mask to serial.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_get_alarms(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<get_alarms>"));
+    }
+#endif
+    cmd_output_uint8(alarm_get());
+    return true;
+} /* cmd_get_alarms() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_tasks
+ *  Purpose	: Get statistics of requested background task.
+ *  Method	: Write all values in one go to serial.
+ *
+ *  The output consists of integers separated by spaces: max. execution time
+ *  in us, budget in us, number of budget overruns and max. start delay in
+ *  ms.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_tasks(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    int16_t		id;		/* task id */
+    taskstats_t		st;		/* statistics */
+    uint16_t		budget;		/* budget in us */
+    bool 		stx = false; 	/* whether STX printed */
 
     id = args[0];
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<get_sensor");
-	Serial.print(" id=");
+	Serial.print(F("<tasks"));
+	Serial.print(F(" id="));
 	Serial.print(id);
-	Serial.print(">");
+	Serial.print(F(">"));
     }
 #endif
 
-    if ((val = sensor_get_value((sensor_t)id)) < EPS) {
-	return false;
+    if (!task_get_stats((task_t)id, &st, &budget)) return false;
+    if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
+        Serial.write((byte)CONTROL_STX);
+	stx = true;
+    }
+    Serial.print(st.maxtime);
+    Serial.write(' ');
+    Serial.print(budget);
+    Serial.write(' ');
+    Serial.print(st.overruns);
+    Serial.write(' ');
+    Serial.print(st.maxlate);
+    if (stx) {
+        Serial.write((byte)CONTROL_ETX);
+    }
+    return true;
+} /* cmd_tasks() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_get_watchdog
+ *  Purpose	: Get statistics of the OSD enable watchdog.
+ *  Method	: Write all values in one go to serial.
+ *
+ *  The output consists of integers separated by spaces: number of checks,
+ *  number of restores and current check interval in ms.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_get_watchdog(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    vm0stats_t		st;		/* statistics */
+    bool 		stx = false; 	/* whether STX printed */
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<get_watchdog>"));
     }
+#endif
+
+    max_get_watchdog(&st);
     if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
         Serial.write((byte)CONTROL_STX);
 	stx = true;
     }
-    Serial.print(val);
+    Serial.print(st.checks);
+    Serial.write(' ');
+    Serial.print(st.restores);
+    Serial.write(' ');
+    Serial.print(st.interval);
     if (stx) {
         Serial.write((byte)CONTROL_ETX);
     }
     return true;
-} /* cmd_get_sensor() */
+} /* cmd_get_watchdog() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cmd_get_vsync
+ *  Purpose	: Get vertical sync timing.
+ *  Method	: Write all values in one go to serial.
+ *
+ *  The output consists of integers separated by spaces: field rate in
+ *  0.01 Hz, average field time in us, max. jitter in us since the previous
+ *  call, number of fields, missed vsyncs and vsync losses.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+cmd_get_vsync(
+    int32_t 	*args,	/* integer arguments */
+		...)	/* data arguments */
+{
+    vsyncstats_t	st;		/* statistics */
+    bool 		stx = false; 	/* whether STX printed */
+
+#ifndef NO_DEBUG
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	Serial.print(F("<get_vsync>"));
+    }
+#endif
+
+    max_get_vsync(&st);
+    if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
+        Serial.write((byte)CONTROL_STX);
+	stx = true;
+    }
+    Serial.print(st.fieldtime == 0 ? 0 : 100000000UL / st.fieldtime);
+    Serial.write(' ');
+    Serial.print(st.fieldtime);
+    Serial.write(' ');
+    Serial.print(st.jitter);
+    Serial.write(' ');
+    Serial.print(st.fields);
+    Serial.write(' ');
+    Serial.print(st.missed);
+    Serial.write(' ');
+    Serial.print(st.losses);
+    if (stx) {
+        Serial.write((byte)CONTROL_ETX);
+    }
+    return true;
+} /* cmd_get_vsync() */
 
 
 /*------------------------------------------------------------------------
@@ -1388,7 +2356,7 @@ cmd_get_width(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<get_width>");
+	Serial.print(F("<get_width>"));
     }
 #endif
     if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
@@ -1420,7 +2388,7 @@ cmd_get_height(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<get_height>");
+	Serial.print(F("<get_height>"));
     }
 #endif
     if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
@@ -1452,7 +2420,7 @@ cmd_get_time(
 
 #ifndef NO_DEBUG
     if (!cfg_get_silent() && cfg_get_debug()) {
-	Serial.print("<get_time>");
+	Serial.print(F("<get_time>"));
     }
 #endif
     if (!cfg_get_silent() && (cfg_get_control() & 0x01) != 0x00) {
@@ -54,14 +54,39 @@ X(CMD_INSMUX1,		"INSMUX1",	cmd_insmux1,	1, 	false)	\
 X(CMD_INSMUX2,		"INSMUX2",	cmd_insmux2,	1, 	false)	\
 X(CMD_CBL,		"CBL",		cmd_cbl,	2, 	false)	\
 X(CMD_CWL,		"CWL",		cmd_cwl,	2, 	false)	\
+X(CMD_ROW_LEVEL,	"ROW_LEVEL",	cmd_row_level,	4, 	false)	\
+X(CMD_ROW_FADE,		"ROW_FADE",	cmd_row_fade,	4, 	false)	\
 X(CMD_P_RAW, 		"P_RAW",	cmd_p_raw,	2, 	true) 	\
 X(CMD_P_WINDOW,		"P_WINDOW",	cmd_p_window,	4, 	true) 	\
 X(CMD_P_BANNER,		"P_BANNER",	cmd_p_banner,	4, 	true) 	\
+X(CMD_P_ATTR,		"P_ATTR",	cmd_p_attr,	4, 	false)	\
+X(CMD_SET_STYLE,	"SET_STYLE",	cmd_set_style,	1, 	false)	\
+X(CMD_FIELD_DEF,	"FIELD_DEF",	cmd_field_def,	4, 	false)	\
+X(CMD_FIELD_SUFFIX,	"FIELD_SUFFIX",	cmd_field_suffix,1, 	true)	\
+X(CMD_SET_FIELD,	"SET_FIELD",	cmd_set_field,	2, 	false)	\
+X(CMD_BAR,		"BAR",		cmd_bar,	4, 	false)	\
+X(CMD_GAUGE,		"GAUGE",	cmd_gauge,	4, 	false)	\
+X(CMD_FIELD_RANGE,	"FIELD_RANGE",	cmd_field_range,3, 	false)	\
+X(CMD_TILE_DEF,		"TILE_DEF",	cmd_tile_def,	3, 	true)	\
+X(CMD_BLIT,		"BLIT",		cmd_blit,	4, 	false)	\
+X(CMD_HORIZON_DEF,	"HORIZON_DEF",	cmd_horizon_def,4, 	false)	\
+X(CMD_HORIZON,		"HORIZON",	cmd_horizon,	2, 	false)	\
 X(CMD_FONT_EFFECT, 	"FONT_EFFECT",	cmd_font_effect,1, 	false)	\
 X(CMD_FONT_RESET, 	"FONT_RESET",	cmd_font_reset, 0, 	false)	\
 X(CMD_SET_FONT, 	"SET_FONT",	cmd_set_font,	1, 	true)	\
 X(CMD_GET_FONT, 	"GET_FONT",	cmd_get_font,	1, 	false)	\
+X(CMD_FONT_STATUS, 	"FONT_STATUS",	cmd_font_status,0, 	false)	\
+X(CMD_FONT_CRC, 	"FONT_CRC",	cmd_font_crc,	2, 	false)	\
 X(CMD_GET_SENSOR, 	"GET_SENSOR",	cmd_get_sensor,	1, 	false)	\
+X(CMD_GET_MAH, 		"GET_MAH",	cmd_get_mah,	1, 	false)	\
+X(CMD_RESET_MAH, 	"RESET_MAH",	cmd_reset_mah,	0, 	false)	\
+X(CMD_SUBSCRIBE, 	"SUBSCRIBE",	cmd_subscribe,	3, 	false)	\
+X(CMD_STATS, 		"STATS",	cmd_stats,	1, 	false)	\
+X(CMD_STATS_RESET, 	"STATS_RESET",	cmd_stats_reset,0, 	false)	\
+X(CMD_GET_ALARMS, 	"GET_ALARMS",	cmd_get_alarms,	0, 	false)	\
+X(CMD_TASKS, 		"TASKS",	cmd_tasks,	1, 	false)	\
+X(CMD_GET_WATCHDOG, 	"GET_WATCHDOG",	cmd_get_watchdog,0, 	false)	\
+X(CMD_GET_VSYNC, 	"GET_VSYNC",	cmd_get_vsync,	0, 	false)	\
 X(CMD_GET_WIDTH, 	"GET_WIDTH",	cmd_get_width,	0, 	false)	\
 X(CMD_GET_HEIGHT, 	"GET_HEIGHT",	cmd_get_height,	0, 	false)	\
 X(CMD_GET_TIME, 	"GET_TIME",	cmd_get_time,	0, 	false)	\
@@ -102,7 +127,7 @@ typedef struct cmdprops_t {		/* command properties */
     bool	use_data;		/* whether to use data */
 } cmdprops_t, *cmdprops_p;
 
-extern cmdprops_t CMD_PROPS[];
+extern const cmdprops_t CMD_PROPS[];
 extern const char * const CMD_NAMES[];
 
 #endif /* COMMAND_H */
@@ -55,7 +55,7 @@ const uint16_t CFG_SIZES[] PROGMEM = {
 };
 #undef X
 
-str16_t 	VERSION = "GSOSD 1.2.0";	/* current version */
+str16_t 	VERSION = "GSOSD 1.3.6";	/* current version */
 configdata_t 	configdata;			/* configurable parameters */
 
 /* X-macro generating local prototypes. */
@@ -237,7 +237,7 @@ cfg_load(
 {
     /* if configdata contains pad bytes, these will be read too */
     for (uint16_t i = 0; i < sizeof(configdata); i++) {
-        ((uint8_t *)&configdata)[i] = EEPROM.read(i);
+        ((uint8_t *)&configdata)[i] = EEPROM.read(EEPROM_CFG_ADDR + i);
     }
     if (init && (strcmp(configdata.version, VERSION) != 0)) {
 	cfg_load_defaults();
@@ -247,9 +247,9 @@ cfg_load(
 
 
 /*------------------------------------------------------------------------
- *  Function	: cfg_save
- *  Purpose	: Save configuration to eeprom.
- *  Method	: Write all changed configuration to eeprom.
+ *  Function	: cfg_write
+ *  Purpose	: Write a byte to eeprom.
+ *  Method	: Write only if changed, delay after each write.
  *
  *  The eeprom has an expected lifespan of approx. 100.000 write cycles.
  *  We try to protect against abuse and bugs by a delay after each write.
@@ -266,6 +266,33 @@ cfg_load(
  *  replug the power periodically. But this will wear out the power button
  *  faster than the eeprom :-)
  *
+ *  All eeprom contents that can be written on request go through here, so
+ *  that they share the delay.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+cfg_write(
+    uint16_t	addr,	/* eeprom address */
+    uint8_t	val)	/* value to write */
+{
+    static uint32_t	count = 0;	/* increasing delay to prevent wear */
+
+    if (val != EEPROM.read(addr)) {	/* prevent wear */
+	EEPROM.write(addr, val);
+	delay(++count >> 4);	/* mitigate errors and abuse */
+    }
+} /* cfg_write() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: cfg_save
+ *  Purpose	: Save configuration to eeprom.
+ *  Method	: Write all changed configuration to eeprom.
+ *
+ *  See cfg_write() about wear.
+ *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
@@ -274,18 +301,12 @@ cfg_save(
     bool 	init)	/* whether called by initial setup */
 {
     bool 		ok = true;	/* whether to proceed */
-    uint8_t		val;		/* eeprom value */
-    static uint32_t	count = 0;	/* increasing delay to prevent wear */
 
     (void)init;
     ok = ok && max_regsetget(&configdata.maxregs);
     /* if configdata contains pad bytes, these will be written too */
     for (uint16_t i = 0; ok && i < sizeof(configdata); i++) {
-        val = ((uint8_t *)&configdata)[i];
-        if (val != EEPROM.read(i)) {	/* prevent unnecessary wear */
-            EEPROM.write(i, val);
-	    delay(++count >> 4);	/* mitigate errors and abuse */
-	}
+	cfg_write(EEPROM_CFG_ADDR + i, ((uint8_t *)&configdata)[i]);
     }
     return ok;
 } /* cfg_save() */
@@ -314,13 +335,13 @@ cfg_dump(void)
     }
     ok = ok && max_regsetget(&configdata.maxregs);
     if (ok) {
-	Serial.print("Total size: ");
+	Serial.print(F("Total size: "));
 	Serial.println(sizeof(configdata));
     }
     for (i = 0; ok && i < CONFIG_COUNT; i++) {
 	strlcpy_P(buf, (char *)pgm_read_word(&(CFG_NAMES[i])), sizeof(buf));
 	Serial.print(buf);
-	Serial.print(" ");
+	Serial.print(F(" "));
 	Serial.print(pgm_read_word_near(CFG_SIZES + i));
 	Serial.println();
     }
@@ -329,7 +350,7 @@ cfg_dump(void)
 	    if (i % 16 == 0) {
 		Serial.println();
 	    } else {
-		Serial.print(" ");
+		Serial.print(F(" "));
 	    }
 	}
         val = ((uint8_t *)&configdata)[i];
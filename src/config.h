@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "max7456.h"
+#include "tile.h"
 
 /*
  * The version string is only used to force an eeprom reset when it changes.
@@ -43,6 +44,19 @@ extern str16_t VERSION;
 
 #define CFG_SIZE (16)	/* Maximum size for name in bytes */
 
+/*
+ * Eeprom layout. The configuration data starts at address 0. The consumed
+ * charge is stored in a ring of slots at the end of the eeprom, so that
+ * periodic saving spreads the wear over several cells. Character tiles
+ * are stored right before that, each in a slot of 2 size bytes and
+ * TILE_CELLS characters.
+ */
+#define EEPROM_CFG_ADDR	(0)
+#define EEPROM_MAH_SLOTS (16)
+#define EEPROM_MAH_ADDR	(E2END + 1 - 4 * EEPROM_MAH_SLOTS)
+#define EEPROM_TILE_SLOT (2 + TILE_CELLS)
+#define EEPROM_TILE_ADDR (EEPROM_MAH_ADDR - TILE_COUNT * EEPROM_TILE_SLOT)
+
 /* A list of all configurable parameters */
 /* key		name	   var/functype		stype		default	     */
 #define CONFIG_TABLE0 							     \
@@ -65,6 +79,28 @@ X(CFG_SENSADJ0,	"SENSADJ0",sensadj0, uint16_t,	uint16_t,       20000)	     \
 X(CFG_SENSADJ1,	"SENSADJ1",sensadj1, uint16_t,	uint16_t,       20000)	     \
 X(CFG_SENSADJ2,	"SENSADJ2",sensadj2, uint16_t,	uint16_t,       20000)	     \
 X(CFG_SENSADJ3,	"SENSADJ3",sensadj3, uint16_t,	uint16_t,       20000)	     \
+X(CFG_OVERSAMPLE,"OVERSAMPLE",oversample,uint8_t,uint8_t,      2)	     \
+X(CFG_CURRSCALE,"CURRSCALE",currscale,uint16_t,uint16_t,    250)	     \
+X(CFG_CURROFFS,	"CURROFFS",curroffs, uint16_t,	uint16_t,       0)	     \
+X(CFG_CAPACITY,	"CAPACITY",capacity, uint16_t,	uint16_t,       0)	     \
+X(CFG_MAHKEEP,	"MAHKEEP", mahkeep,  bool,	bool,   	false)	     \
+X(CFG_ALARMLO0,	"ALARMLO0",alarmlo0, uint16_t,	uint16_t,       0)	     \
+X(CFG_ALARMHI0,	"ALARMHI0",alarmhi0, uint16_t,	uint16_t,       0)	     \
+X(CFG_ALARMLO1,	"ALARMLO1",alarmlo1, uint16_t,	uint16_t,       0)	     \
+X(CFG_ALARMHI1,	"ALARMHI1",alarmhi1, uint16_t,	uint16_t,       0)	     \
+X(CFG_ALARMLO2,	"ALARMLO2",alarmlo2, uint16_t,	uint16_t,       0)	     \
+X(CFG_ALARMHI2,	"ALARMHI2",alarmhi2, uint16_t,	uint16_t,       0)	     \
+X(CFG_ALARMLO3,	"ALARMLO3",alarmlo3, uint16_t,	uint16_t,       0)	     \
+X(CFG_ALARMHI3,	"ALARMHI3",alarmhi3, uint16_t,	uint16_t,       0)	     \
+X(CFG_ALARMHYST,"ALARMHYST",alarmhyst,uint16_t,	uint16_t,       100)	     \
+X(CFG_ALARMX,	"ALARMX",  alarmx,   uint8_t,	uint8_t,        10)	     \
+X(CFG_ALARMY,	"ALARMY",  alarmy,   uint8_t,	uint8_t,        7)	     \
+X(CFG_REFRESHMAX,"REFRESHMAX",refreshmax,uint16_t,uint16_t,   0)	     \
+X(CFG_RAMPCHAR,	"RAMPCHAR",rampchar, uint8_t,	uint8_t,        9)	     \
+X(CFG_RAMPSTEPS,"RAMPSTEPS",rampsteps,uint8_t,	uint8_t,        4)	     \
+X(CFG_VRAMPCHAR,"VRAMPCHAR",vrampchar,uint8_t,	uint8_t,        0)	     \
+X(CFG_HORIZCHAR,"HORIZCHAR",horizchar,uint8_t,	uint8_t,        0)	     \
+X(CFG_HORIZSTEPS,"HORIZSTEPS",horizsteps,uint8_t,uint8_t,      3)	     \
 
 /* Following values are for standalone build only. */
 #define CONFIG_TABLE2							     \
@@ -88,6 +124,35 @@ X(CFG_TIMEV, 	"TIMEV",   timev,    bool,	bool,	  	true)	     \
 X(CFG_TIMEX,	"TIMEX",   timex,    uint8_t,	uint8_t,  	1)	     \
 X(CFG_TIMEY,	"TIMEY",   timey,    uint8_t,	uint8_t,  	5)	     \
 X(CFG_TIMET,	"TIMET",   timet,    str_t,	str5_t,  	"")	     \
+X(CFG_MAHV, 	"MAHV",    mahv,     bool,	bool,	  	false)	     \
+X(CFG_MAHX,	"MAHX",    mahx,     uint8_t,	uint8_t,  	1)	     \
+X(CFG_MAHY,	"MAHY",    mahy,     uint8_t,	uint8_t,  	6)	     \
+X(CFG_MAHT,	"MAHT",    maht,     str_t,	str5_t,  	"mAh")	     \
+X(CFG_PCTV0, 	"PCTV0",   pctv0,    bool,	bool,	  	false)	     \
+X(CFG_PCTX0,	"PCTX0",   pctx0,    uint8_t,	uint8_t,  	8)	     \
+X(CFG_PCTY0,	"PCTY0",   pcty0,    uint8_t,	uint8_t,  	1)	     \
+X(CFG_PCTV1, 	"PCTV1",   pctv1,    bool,	bool,	  	false)	     \
+X(CFG_PCTX1,	"PCTX1",   pctx1,    uint8_t,	uint8_t,  	8)	     \
+X(CFG_PCTY1,	"PCTY1",   pcty1,    uint8_t,	uint8_t,  	2)	     \
+X(CFG_PCTV2, 	"PCTV2",   pctv2,    bool,	bool,	  	false)	     \
+X(CFG_PCTX2,	"PCTX2",   pctx2,    uint8_t,	uint8_t,  	8)	     \
+X(CFG_PCTY2,	"PCTY2",   pcty2,    uint8_t,	uint8_t,  	3)	     \
+X(CFG_PCTV3, 	"PCTV3",   pctv3,    bool,	bool,	  	false)	     \
+X(CFG_PCTX3,	"PCTX3",   pctx3,    uint8_t,	uint8_t,  	8)	     \
+X(CFG_PCTY3,	"PCTY3",   pcty3,    uint8_t,	uint8_t,  	4)	     \
+X(CFG_BARV0, 	"BARV0",   barv0,    bool,	bool,	  	false)	     \
+X(CFG_BARX0,	"BARX0",   barx0,    uint8_t,	uint8_t,  	13)	     \
+X(CFG_BARY0,	"BARY0",   bary0,    uint8_t,	uint8_t,  	1)	     \
+X(CFG_BARV1, 	"BARV1",   barv1,    bool,	bool,	  	false)	     \
+X(CFG_BARX1,	"BARX1",   barx1,    uint8_t,	uint8_t,  	13)	     \
+X(CFG_BARY1,	"BARY1",   bary1,    uint8_t,	uint8_t,  	2)	     \
+X(CFG_BARV2, 	"BARV2",   barv2,    bool,	bool,	  	false)	     \
+X(CFG_BARX2,	"BARX2",   barx2,    uint8_t,	uint8_t,  	13)	     \
+X(CFG_BARY2,	"BARY2",   bary2,    uint8_t,	uint8_t,  	3)	     \
+X(CFG_BARV3, 	"BARV3",   barv3,    bool,	bool,	  	false)	     \
+X(CFG_BARX3,	"BARX3",   barx3,    uint8_t,	uint8_t,  	13)	     \
+X(CFG_BARY3,	"BARY3",   bary3,    uint8_t,	uint8_t,  	4)	     \
+X(CFG_BARLEN,	"BARLEN",  barlen,   uint8_t,	uint8_t,  	5)	     \
 
 #define CONFIG_TABLE CONFIG_TABLE0 CONFIG_TABLE1 CONFIG_TABLE2
 
@@ -124,6 +189,8 @@ bool cfg_load(bool);
 
 bool cfg_save(bool);
 
+void cfg_write(uint16_t, uint8_t);
+
 bool cfg_dump(void);
 
 #endif /* CONFIG_H */
@@ -38,6 +38,45 @@
 #define PROGMEM __attribute__((section(".progmem.data")))
 #endif
 
+#define FONTCHARS	(256)	/* number of characters in font memory */
+
+/*
+ * Resetting the font or applying an effect to it takes a while; all 256
+ * characters have to be read, modified and written back. Rather than blocking
+ * the main loop, the work is done as a background job that handles a single
+ * character per call to font_task().
+ */
+static uint16_t		fontjob_num = FONTCHARS;/* next char; FONTCHARS=idle */
+static bool		fontjob_reset;		/* whether to reset the font */
+static fonteffect_t	fontjob_effect;		/* effect to apply */
+static uint16_t		fontjob_failed;		/* chars that failed to write */
+
+/*
+ * Nibble lookup table for the standard (IEEE 802.3, reflected) CRC32 as used
+ * by e.g. zlib. A full byte table would take 1 kB of flash; 16 entries are
+ * fast enough for checksumming font memory.
+ */
+const uint32_t CRC32NIBBLE[16] PROGMEM = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+#ifdef FONT_PREBUILT
+/*
+ * Fully processed font that is loaded when resetting the font. Unlike
+ * DEFAULTFONT below, this holds all 2 bits per pixel exactly as they are
+ * written to the Max7456's font memory, so resetting the font doesn't need
+ * any pixel processing. The effect that is already applied is given by
+ * PREBUILTFONT_EFFECT. This takes twice the flash space of DEFAULTFONT, so
+ * it's optional.
+ *
+ * Below data is generated at build time with fonts/gif2osd.php, see
+ * src/Makefile.
+ */
+#include "fontnvm.h"
+#else
 /*
  * Default font that is loaded when resetting the font.
  * The Max7456's font memory stores 256 characters, 18 * 12 pixels per
@@ -70,15 +109,15 @@ const uint8_t DEFAULTFONT[256][(18 * 12 / 8)] PROGMEM = {
     { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
       0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
     { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-      0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
-    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-      0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
-    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-      0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
-    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-      0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
-    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-      0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+      0x00,0x00,0x00,0x00,0xFF,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0E,0x00,0xE0,0x0E,0x00,0xE0,0x0E,
+      0x00,0xE0,0x0E,0x00,0xFF,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0F,0xC0,0xFC,0x0F,0xC0,0xFC,0x0F,
+      0xC0,0xFC,0x0F,0xC0,0xFF,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0F,0xF8,0xFF,0x8F,0xF8,0xFF,0x8F,
+      0xF8,0xFF,0x8F,0xF8,0xFF,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0F,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+      0xFF,0xFF,0xFF,0xFF,0xFF,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
     { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
       0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
     { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
@@ -564,6 +603,7 @@ const uint8_t DEFAULTFONT[256][(18 * 12 / 8)] PROGMEM = {
     { 0x00,0x00,0x00,0x00,0x00,0xD8,0x0D,0x80,0x00,0x00,0x01,0x8C,0x18,0xC0,
       0xD8,0x0D,0x80,0xD8,0x07,0x00,0x70,0x03,0x00,0x60,0x3E,0x03,0xC0 },
 };
+#endif /* FONT_PREBUILT */
 
 
 /*------------------------------------------------------------------------
@@ -662,142 +702,273 @@ is_transpixel(
 
 
 /*------------------------------------------------------------------------
- *  Function	: font_apply
- *  Purpose	: Reset the font to inbuilt hard-coded values or apply effect
- *  		  to current font.
+ *  Function	: font_applychar
+ *  Purpose	: Reset one font character to inbuilt hard-coded values or
+ *  		  apply effect to it.
  *  Method	: Get font character from progmem or from Max7456 chip,
  *  		  modify, write to Max7456 chip.
  *
- *  Note that font effects do stack on top of each other. For example, if you
- *  apply FE_TRANSWHTE + FE_INVERT then you will get completely black
- *  characters. Then you can even e.g. clear the font by adding another
- *  FE_TRANSWHITE effect.
- *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
  */
-bool
-font_apply(
-    fonteffect_p	fonteffect)	/* effect to apply or NULL to reset */
+static bool
+font_applychar(
+    uint8_t		num,		/* number of character to set */
+    bool		reset,		/* whether to reset the character */
+    fonteffect_t	effect)		/* effect to apply if not reset */
 {
-    int			num;	/* number of character to set [0 .. 255] */
-    fonteffect_t	effect;	/* (default) font effect to apply */
-
-    for (num = 0; num <= 255; num++) {
-	fontbuf_t 	buf;	/* font character buffer */
-	uint8_t 	fbi;	/* byte index in font buffer */
-	uint8_t 	byte;	/* output byte for 4 pixels */
-	uint8_t 	bi;	/* bit index in output byte */
+    fontbuf_t 	buf;	/* font character buffer */
+    uint8_t 	fbi;	/* byte index in font buffer */
+    uint8_t 	byte;	/* output byte for 4 pixels */
+    uint8_t 	bi;	/* bit index in output byte */
 
+    /*
+     * The NVM contains 256 rows of 64 bytes i.e. 512 bits per character;
+     * 432 data bits followed by 80 unused bits. The order of pixels is
+     * from top to bottom and from left to right. See the manual for more
+     * info.
+     */
+    if (reset) {
+#ifdef FONT_PREBUILT
+	/* Reset font. All pixel processing has been done at build time. */
+	memcpy_P(buf, PREBUILTFONT[num], sizeof(buf));
+	return max_fontcharput(num, &buf);
+#else
 	/*
-	 * The NVM contains 256 rows of 64 bytes i.e. 512 bits per character;
-	 * 432 data bits followed by 80 unused bits. The order of pixels is
-	 * from top to bottom and from left to right. See the manual for more
-	 * info.
+	 * Reset font.
+	 * Build a pixel map consisting of white pixels only. Note that the
+	 * characters of harcoded DEFAULTFONT take half the space of
+	 * fontbuf_t. Bytes in the resulting map are like the NVM from top
+	 * to bottom and from left to right. Each byte is MSB-first so e.g.
+	 * 0x01 tells that the first pixel is white, followed by 3 yet to
+	 * determine black or tranparent pixels.
 	 */
-	if (fonteffect == NULL) {
-	    /*
-	     * Reset font.
-	     * Build a pixel map consisting of white pixels only. Note that the
-	     * characters of harcoded DEFAULTFONT take half the space of
-	     * fontbuf_t. Bytes in the resulting map are like the NVM from top
-	     * to bottom and from left to right. Each byte is MSB-first so e.g.
-	     * 0x01 tells that the first pixel is white, followed by 3 yet to
-	     * determine black or tranparent pixels.
-	     */
-	    for (uint8_t i = 0; i < sizeof(buf) / 2; i++) {
-		byte = pgm_read_byte(&(DEFAULTFONT[num][i]));
-		buf[2 * i] = 0x00;
-		buf[2 * i + 1] = 0x00;
-	        for (bi = 0; bi < 8; bi++) {
-                    if (((byte & (0x01 << (7 - bi))) != 0x00)) {
-			if (bi < 4) {
-		            buf[2 * i] |= (0x01 << (7 - (2 * bi)));
-			} else {
-		            buf[2 * i + 1] |= (0x01 << (7 - (2 * (bi - 4))));
-			}
+	for (uint8_t i = 0; i < sizeof(buf) / 2; i++) {
+	    byte = pgm_read_byte(&(DEFAULTFONT[num][i]));
+	    buf[2 * i] = 0x00;
+	    buf[2 * i + 1] = 0x00;
+	    for (bi = 0; bi < 8; bi++) {
+		if (((byte & (0x01 << (7 - bi))) != 0x00)) {
+		    if (bi < 4) {
+			buf[2 * i] |= (0x01 << (7 - (2 * bi)));
+		    } else {
+			buf[2 * i + 1] |= (0x01 << (7 - (2 * (bi - 4))));
 		    }
 		}
 	    }
-	    effect = FE_BORDER;
-	} else {
-	    /* Font effect. Get pixel map from Max7456 eeprom. */
-	    max_fontcharget((uint8_t)num, &buf);
-	    effect = *fonteffect;
 	}
-	if (num == 0) effect = FE_NONE;	/* Keep empty cells transparent. */
+	effect = FE_BORDER;
+#endif
+    } else {
+	/* Font effect. Get pixel map from Max7456 eeprom. */
+	if (!max_fontcharget(num, &buf)) return false;
+    }
+    if (num == 0) effect = FE_NONE;	/* Keep empty cells transparent. */
 
-	/* Intinialise counters and output byte. */
-	fbi = 0;
-	bi = 0;
-	byte = 0x00;
+    /* Intinialise counters and output byte. */
+    fbi = 0;
+    bi = 0;
+    byte = 0x00;
 
-        /* Walk 18 vertical character pixels. */
-	for (uint8_t y = 0; y < 18; y++) {
+    /* Walk 18 vertical character pixels. */
+    for (uint8_t y = 0; y < 18; y++) {
 
-            /* Walk 12 horizontal character pixels. */
-	    for (uint8_t x = 0; x < 12; x++) {
+	/* Walk 12 horizontal character pixels. */
+	for (uint8_t x = 0; x < 12; x++) {
+	    /*
+	     * Set next two output bits for this pixel:
+	     * "00" : black opaque
+	     * "10" : white opaque
+	     * "*1" : transparent (default)
+	     */
+	    if (is_whitepixel(&buf, x, y)) {
+		/* Set white bit or keep it zero (black) upon invert. */
+		if (effect != FE_INVERT) {
+		    byte |= (0x01 << (7 - bi));
+		}
+	    } else {
 		/*
-		 * Set next two output bits for this pixel:
-		 * "00" : black opaque
-		 * "10" : white opaque
-		 * "*1" : transparent (default)
+		 * Possibly set transparent bit (if not black) or set white
+		 * bit upon invert.
 		 */
-		if (is_whitepixel(&buf, x, y)) {
-		    /* Set white bit or keep it zero (black) upon invert. */
-		    if (effect != FE_INVERT) {
-		        byte |= (0x01 << (7 - bi));
+		switch (effect) {
+		case FE_BORDER:
+		    if (!((x > 0 && is_whitepixel(&buf, x - 1, y))
+			|| (x < 11 && is_whitepixel(&buf, x + 1, y))
+			|| (y > 0 && is_whitepixel(&buf, x, y - 1))
+			|| (y < 17 && is_whitepixel(&buf, x, y + 1)))) {
+			byte |= (0x01 << (6 - bi));
 		    }
-		} else {
-		    /*
-		     * Possibly set transparent bit (if not black) or set white
-		     * bit upon invert.
-		     */
-		    switch (effect) {
-		    case FE_BORDER:
-			if (!((x > 0 && is_whitepixel(&buf, x - 1, y))
-			    || (x < 11 && is_whitepixel(&buf, x + 1, y))
-			    || (y > 0 && is_whitepixel(&buf, x, y - 1))
-			    || (y < 17 && is_whitepixel(&buf, x, y + 1)))) {
-			    byte |= (0x01 << (6 - bi));
-			}
-			break;
-		    case FE_SHADOW:
-			if (!((x > 0 && is_whitepixel(&buf, x - 1, y))
-			    || (y > 0 && is_whitepixel(&buf, x, y - 1)))) {
-			    byte |= (0x01 << (6 - bi));
-			}
-			break;
-		    case FE_NONE:
-			/* fallthrough */
-		    case FE_TRANSWHITE:
+		    break;
+		case FE_SHADOW:
+		    if (!((x > 0 && is_whitepixel(&buf, x - 1, y))
+			|| (y > 0 && is_whitepixel(&buf, x, y - 1)))) {
 			byte |= (0x01 << (6 - bi));
-			break;
-		    case FE_BLACKWHITE:
-			    /* Keep pixel black. */
-			break;
-		    case FE_INVERT:
-			if (is_blackpixel(&buf, x, y)) {
-			    /* Set white bit. */
-			    byte |= (0x01 << (7 - bi));
-			} else {
-			    /* Set transparent bit. */
-			    byte |= (0x01 << (6 - bi));
-			}
-			break;
-		    default:
-			break;
 		    }
-		}
-		bi += 2;
-		if (bi == 8) {
-		    if (fbi < sizeof(buf)) buf[fbi++] = byte;
-		    byte = 0x00;
-		    bi = 0;
+		    break;
+		case FE_NONE:
+		    /* fallthrough */
+		case FE_TRANSWHITE:
+		    byte |= (0x01 << (6 - bi));
+		    break;
+		case FE_BLACKWHITE:
+			/* Keep pixel black. */
+		    break;
+		case FE_INVERT:
+		    if (is_blackpixel(&buf, x, y)) {
+			/* Set white bit. */
+			byte |= (0x01 << (7 - bi));
+		    } else {
+			/* Set transparent bit. */
+			byte |= (0x01 << (6 - bi));
+		    }
+		    break;
+		default:
+		    break;
 		}
 	    }
+	    bi += 2;
+	    if (bi == 8) {
+		if (fbi < sizeof(buf)) buf[fbi++] = byte;
+		byte = 0x00;
+		bi = 0;
+	    }
 	}
-	max_fontcharput((uint8_t)num, &buf);
     }
+    return max_fontcharput(num, &buf);
+} /* font_applychar() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: font_task
+ *  Purpose	: Proceed with background font job, if any.
+ *  Method	: Handle the next font character of the job.
+ *
+ *  Returns	: True if a character has been handled, false if idle.
+ *------------------------------------------------------------------------
+ */
+bool
+font_task(void)
+{
+    if (fontjob_num >= FONTCHARS) return false;
+
+    if (!font_applychar((uint8_t)fontjob_num, fontjob_reset, fontjob_effect)) {
+	fontjob_failed++;
+    }
+    fontjob_num++;
+    return true;
+} /* font_task() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: font_flush
+ *  Purpose	: Finish background font job, if any.
+ *  Method	: Call font_task() until it has nothing left to do.
+ *
+ *  This is used before accessing the font memory otherwise, so that
+ *  operations don't get mixed up.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+font_flush(void)
+{
+    while (font_task());
+} /* font_flush() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: font_pending
+ *  Purpose	: Get progress of background font job.
+ *  Method	: Use job counter.
+ *
+ *  Returns	: Number of font characters still to handle; 0 if idle.
+ *------------------------------------------------------------------------
+ */
+uint16_t
+font_pending(void)
+{
+    return FONTCHARS - fontjob_num;
+} /* font_pending() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: font_failed
+ *  Purpose	: Get failures of last background font job.
+ *  Method	: Use failure counter.
+ *
+ *  Returns	: Number of font characters that failed to be written.
+ *------------------------------------------------------------------------
+ */
+uint16_t
+font_failed(void)
+{
+    return fontjob_failed;
+} /* font_failed() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: font_apply
+ *  Purpose	: Reset the font to inbuilt hard-coded values or apply effect
+ *  		  to current font.
+ *  Method	: Finish running job, start a new background job. The actual
+ *  		  work is done by font_task().
+ *
+ *  Note that font effects do stack on top of each other. For example, if you
+ *  apply FE_TRANSWHTE + FE_INVERT then you will get completely black
+ *  characters. Then you can even e.g. clear the font by adding another
+ *  FE_TRANSWHITE effect.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+font_apply(
+    fonteffect_p	fonteffect)	/* effect to apply or NULL to reset */
+{
+    font_flush();
+    fontjob_reset = (fonteffect == NULL);
+    fontjob_effect = fontjob_reset ? FE_BORDER : *fonteffect;
+    fontjob_failed = 0;
+    fontjob_num = 0;
     return true;
 } /* font_apply() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: font_crc32
+ *  Purpose	: Calculate CRC32 over a range of font characters.
+ *  Method	: Read characters from Max7456 chip and feed all bytes to a
+ *  		  nibble-wise CRC32 calculation.
+ *
+ *  The result is the standard CRC32 of the concatenated 54-byte characters,
+ *  so a client can compare it with e.g. zlib's crc32() of its own font data.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+font_crc32(
+    uint8_t	first,		/* first character of range */
+    uint8_t	last,		/* last character of range */
+    uint32_t	*crc)		/* resulting checksum */
+{
+    fontbuf_t 	buf;		/* font character buffer */
+    uint32_t	c;		/* running checksum */
+    uint16_t	num;		/* number of character */
+
+    if (crc == NULL || first > last) return false;
+
+    c = 0xFFFFFFFF;
+    for (num = first; num <= last; num++) {
+	if (!max_fontcharget((uint8_t)num, &buf)) return false;
+	for (uint8_t i = 0; i < sizeof(buf); i++) {
+	    c ^= buf[i];
+	    c = (c >> 4) ^ pgm_read_dword(&CRC32NIBBLE[c & 0x0F]);
+	    c = (c >> 4) ^ pgm_read_dword(&CRC32NIBBLE[c & 0x0F]);
+	}
+    }
+    *crc = ~c;
+    return true;
+} /* font_crc32() */
@@ -38,5 +38,15 @@ typedef enum {		/* possible font effects on currently loaded font */
 
 bool font_apply(fonteffect_p);
 
+bool font_task(void);
+
+void font_flush(void);
+
+uint16_t font_pending(void);
+
+uint16_t font_failed(void);
+
+bool font_crc32(uint8_t, uint8_t, uint32_t *);
+
 #endif /* FONT_H */
 
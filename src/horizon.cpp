@@ -0,0 +1,256 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: horizon.cpp
+ *  Purpose	: Artificial horizon drawn by the OSD.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+#include "max7456.h"
+#include "horizon.h"
+
+//Workaround for http://gcc.gnu.org/bugzilla/show_bug.cgi?id=34734
+#ifdef PROGMEM
+#undef PROGMEM
+#define PROGMEM __attribute__((section(".progmem.data")))
+#endif
+
+#define CHARWIDTH	(12)	/* character width in pixels */
+#define CHARHEIGHT	(18)	/* character height in pixels */
+
+/* Sine of 0, 1, .. 90 degrees, times 16384. */
+const uint16_t SINE[91] PROGMEM = {
+        0,   286,   572,   857,  1143,  1428,  1713,  1997,
+     2280,  2563,  2845,  3126,  3406,  3686,  3964,  4240,
+     4516,  4790,  5063,  5334,  5604,  5872,  6138,  6402,
+     6664,  6924,  7182,  7438,  7692,  7943,  8192,  8438,
+     8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982,
+    12176, 12365, 12551, 12733, 12911, 13085, 13255, 13421,
+    13583, 13741, 13894, 14044, 14189, 14330, 14466, 14598,
+    14726, 14849, 14968, 15082, 15191, 15296, 15396, 15491,
+    15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362,
+    16374, 16382, 16384
+};
+
+/*
+ * Glyphs of the default font for a line at the top, middle and bottom of
+ * a character (iso-8859-1 macron, hyphen and underscore).
+ */
+const uint8_t HORIZONGLYPHS[3] PROGMEM = {0xAF, '-', '_'};
+
+/*
+ * Horizon area and what was drawn in it. A shallow line has one character
+ * per column, a steep one per row, so hdrawn[] holds the row of each
+ * column or the column of each row, plus 1, 0 meaning nothing drawn.
+ */
+static int8_t	hx;			/* x-position of area */
+static int8_t	hy;			/* y-position of area */
+static uint8_t	hwidth;			/* area width, 0 if unused */
+static uint8_t	hheight;		/* area height */
+static bool	hsteep;			/* whether drawn per row */
+static uint8_t	hdrawn[MAXCOLS];	/* drawn position + 1, 0 if none */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: horizon_sin
+ *  Purpose	: Get sine of an angle.
+ *  Method	: Look up in SINE table.
+ *
+ *  Returns	: Sine times 16384, for -90 - 90 degrees.
+ *------------------------------------------------------------------------
+ */
+static int16_t
+horizon_sin(
+    int16_t	deg)	/* angle in degrees */
+{
+    if (deg < 0) return -(int16_t)pgm_read_word(&SINE[-deg]);
+    return pgm_read_word(&SINE[deg]);
+} /* horizon_sin() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: horizon_pos
+ *  Purpose	: Get screen position of a character in the area.
+ *  Method	: Swap row and column for a steep line.
+ *
+ *  Returns	: Position in screenbuf, or -1 if outside the screen.
+ *------------------------------------------------------------------------
+ */
+static int16_t
+horizon_pos(
+    uint8_t	i,	/* column, or row if steep */
+    uint8_t	m)	/* row, or column if steep */
+{
+    uint8_t	x = hx + (hsteep ? m : i);	/* x-position */
+    uint8_t	y = hy + (hsteep ? i : m);	/* y-position */
+
+    if (x >= screenbuf.cols || y >= screenbuf.rows) return -1;
+    return y * screenbuf.cols + x;
+} /* horizon_pos() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: horizon_clear
+ *  Purpose	: Clear the horizon line.
+ *  Method	: Clear characters drawn before.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+horizon_clear(void)
+{
+    int16_t	pos;	/* screenbuf position */
+
+    for (uint8_t i = 0; i < MAXCOLS; i++) {
+	if (hdrawn[i] != 0) {
+	    if ((pos = horizon_pos(i, hdrawn[i] - 1)) >= 0) {
+		SCREENUPDATE(screenbuf, pos, 0x00);
+	    }
+	    hdrawn[i] = 0;
+	}
+    }
+} /* horizon_clear() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: horizon_def
+ *  Purpose	: Define the horizon area.
+ *  Method	: Clear line drawn before, store area.
+ *
+ *  A width or height of 0 removes the horizon.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+horizon_def(
+    int16_t	x,	/* x-position */
+    int16_t	y,	/* y-position */
+    int16_t	width,	/* width in characters */
+    int16_t	height)	/* height in characters */
+{
+    if (x < 0 || y < 0 || width < 0 || height < 0
+	|| x + width > MAXCOLS || y + height > MAXROWS) {
+	return false;
+    }
+    horizon_clear();
+    hx = x;
+    hy = y;
+    hwidth = height == 0 ? 0 : width;
+    hheight = height;
+    return true;
+} /* horizon_def() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: horizon_set
+ *  Purpose	: Draw the horizon for an attitude.
+ *  Method	: Intersect the horizon line with each column or row.
+ *
+ *  The line runs through the area center, shifted down by the pitch. It
+ *  is computed in pixels with the sine table. A shallow line (roll up to
+ *  45 degrees) gets one character per column, picking the glyph that has
+ *  its line nearest to the intersection. These are HORIZSTEPS characters
+ *  from HORIZCHAR with the line from top to bottom, or the macron, hyphen
+ *  and underscore of the default font if HORIZCHAR is 0. A steep line gets
+ *  one slash or bar per row. The line gets the given attributes, cleared
+ *  characters normal ones. Only characters that changed are set.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+horizon_set(
+    int32_t	roll,	/* roll in degrees, positive is right wing down */
+    int32_t	pitch,	/* pitch in degrees, positive is nose up */
+    uint8_t	attr)	/* attributes of the line */
+{
+    int16_t	s;		/* sine of roll */
+    int16_t	c;		/* cosine of roll */
+    int16_t	cx;		/* area center x in pixels */
+    int16_t	cy;		/* area center y in pixels */
+    bool	steep;		/* whether drawn per row */
+    uint8_t	n;		/* number of columns or rows */
+    uint8_t	steps;		/* glyphs of a shallow line */
+    uint8_t	m;		/* row (column if steep) + 1, 0 if none */
+    char	glyph;		/* character to draw */
+    uint8_t	step;		/* glyph index */
+    int32_t	p;		/* intersection in pixels */
+    int16_t	pos;		/* screenbuf position */
+
+    if (hwidth == 0) return false;
+    roll %= 360;
+    if (roll > 180) roll -= 360;
+    if (roll < -180) roll += 360;
+    if (roll > 90 || roll < -90) {	/* upside down */
+	roll += roll > 0 ? -180 : 180;
+	pitch = -pitch;
+    }
+    if (pitch > 90) pitch = 90;
+    if (pitch < -90) pitch = -90;
+    s = horizon_sin(roll);
+    c = horizon_sin(90 - (roll < 0 ? -roll : roll));
+    cx = hwidth * CHARWIDTH / 2;
+    cy = hheight * CHARHEIGHT / 2 + pitch * CHARHEIGHT / HORIZON_DEGROW;
+    steep = roll > 45 || roll < -45;
+    steps = cfg_get_horizchar() == 0 ? 3 : cfg_get_horizsteps();
+    if (steps == 0) steps = 1;
+    if (steep != hsteep) {
+	horizon_clear();
+	hsteep = steep;
+    }
+    n = steep ? hheight : hwidth;
+    for (uint8_t i = 0; i < n; i++) {
+	m = 0;
+	if (steep) {
+	    p = cx - (int32_t)(i * CHARHEIGHT + CHARHEIGHT / 2 - cy) * c / s;
+	    if (p >= 0 && p < hwidth * CHARWIDTH) {
+		m = p / CHARWIDTH + 1;
+		glyph = roll > 75 || roll < -75 ? '|' : roll > 0 ? '/' : '\\';
+	    }
+	} else {
+	    p = cy - (int32_t)(i * CHARWIDTH + CHARWIDTH / 2 - cx) * s / c;
+	    if (p >= 0 && p < hheight * CHARHEIGHT) {
+		m = p / CHARHEIGHT + 1;
+		step = (p % CHARHEIGHT) * steps / CHARHEIGHT;
+		glyph = cfg_get_horizchar() == 0
+		    ? pgm_read_byte(&HORIZONGLYPHS[step])
+		    : cfg_get_horizchar() + step;
+	    }
+	}
+	if (hdrawn[i] != 0 && hdrawn[i] != m) {
+	    if ((pos = horizon_pos(i, hdrawn[i] - 1)) >= 0) {
+		SCREENUPDATE(screenbuf, pos, 0x00);
+	    }
+	}
+	if (m != 0 && (pos = horizon_pos(i, m - 1)) >= 0) {
+	    SCREENUPDATEATTR(screenbuf, pos, glyph, attr);
+	}
+	hdrawn[i] = m;
+    }
+    return true;
+} /* horizon_set() */
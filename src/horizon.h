@@ -0,0 +1,38 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: horizon.h
+ *  Purpose	: Declarations for the artificial horizon.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#ifndef HORIZON_H
+#define HORIZON_H
+
+#include <stdint.h>
+
+#define HORIZON_DEGROW	(5)	/* degrees of pitch per character row */
+
+bool horizon_def(int16_t, int16_t, int16_t, int16_t);
+
+bool horizon_set(int32_t, int32_t, uint8_t);
+
+#endif /* HORIZON_H */
@@ -26,6 +26,7 @@
 
 #include <Arduino.h>
 #include <SPI.h>
+#include <util/atomic.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include "config.h"
@@ -107,13 +108,13 @@ regset_t DEFREGVALS = {
 #undef X
 
 typedef struct regsave_t {		/* register save eeprom info */
-    regw_t	reg;			/* writable register */
+    uint8_t	reg;			/* writable register (regw_t) */
     bool	restore_from_eeprom;	/* whether to restore from eeprom */
 } regsave_t, *regsave_p;
 
 /* X-macro generating a lookup list of registers to save in eeprom */
 #define X(addr, key, name, def, restore, stat, dmm) { W_ ## key, restore },
-regsave_t REGSAVE[] = {
+const regsave_t REGSAVE[] PROGMEM = {
     REG_MAP_RW
 };
 #undef X
@@ -126,7 +127,52 @@ regsave_t REGSAVE[] = {
  * command.cpp and is written to screen during Max7456's vertical
  * synchronisation (vsync).
  */
-screenbuf_t 	screenbuf = { {0}, {0}, NTSCROWS, MAXCOLS, false};
+screenbuf_t 	screenbuf = { {0}, {0}, {0}, NTSCROWS, MAXCOLS, false};
+
+#define VM0CHECK_MIN	(100)	/* min. VM0 check interval in ms */
+#define VM0CHECK_MAX	(6400)	/* max. VM0 check interval in ms */
+
+/*
+ * Enable watchdog state. The Max7456 seems to reset the enable bit of
+ * register VM0 now and then. The bit is verified while the chip is selected
+ * anyway for a screen refresh, or else by max_watchdog(). The interval
+ * doubles up to VM0CHECK_MAX while the bit stays correct.
+ */
+static volatile bool		vm0enable = true; /* enable bit last set */
+static volatile uint16_t	vm0interval = VM0CHECK_MIN; /* interval in ms */
+static volatile unsigned long	vm0last;	/* timestamp of last check */
+static volatile uint16_t	vm0checks;	/* number of checks */
+static volatile uint16_t	vm0restores;	/* number of restores needed */
+static volatile uint8_t		vm0val;		/* VM0 value last read/written */
+
+#define FIELD_PAL_MIN	(18500)	/* min. PAL field time in us (20000) */
+#define FIELD_PAL_MAX	(21500)	/* max. PAL field time in us */
+#define FIELD_NTSC_MIN	(15500)	/* min. NTSC field time in us (16683) */
+#define FIELD_NTSC_MAX	(17800)	/* max. NTSC field time in us */
+#define VSYNC_LOST	(100)	/* time in ms without vsync to check STAT */
+#define VDETECT_RETRY	(10)	/* number of retries after vsync change */
+
+/*
+ * Video standard as seen by the vsync interrupt handler, set when two
+ * successive field times match (1 << STAT_PAL) or (1 << STAT_NTSC). A change
+ * makes max_videodetect() read the STAT register without waiting for its
+ * VDETECT period.
+ */
+static volatile uint8_t		vsyncstd;	/* STAT bit of field time */
+static volatile bool		vsyncchange;	/* whether vsyncstd changed */
+static volatile unsigned long	vsynclast;	/* timestamp of last vsync */
+static vsyncstats_t		vsyncstats;	/* vsync statistics */
+static volatile bool		refreshpart;	/* whether refresh is partial */
+
+#define ROWCOUNT	(16)	/* number of row brightness registers */
+
+/*
+ * Cached row brightness registers RB0 - RB15, so that max_rowlevel() can
+ * write them in a burst without reading them back. The cache is loaded on
+ * first use and dropped whenever the registers are changed otherwise.
+ */
+static uint8_t			rbcache[ROWCOUNT]; /* register values */
+static bool			rbvalid;	/* whether rbcache is valid */
 
 
 /*------------------------------------------------------------------------
@@ -211,6 +257,52 @@ reg_getbit(
 } /* reg_getbit() */
 
 
+/*------------------------------------------------------------------------
+ *  Function	: reg_wait_STAT_CHARMEM_UNAVAIL
+ *  Purpose	: Wait until the character memory is available.
+ *  Method	: Poll STAT register for a limited time.
+ *
+ *  Returns	: Indication of success; false upon timeout.
+ *------------------------------------------------------------------------
+ */
+static bool
+reg_wait_STAT_CHARMEM_UNAVAIL(void)
+{
+#define MAXWAIT 100
+
+    int i;		/* number of milliseconds we had to wait */
+
+    for (i = 0;
+	 i < MAXWAIT && reg_getbit(R_STAT, STAT_CHARMEM_UNAVAIL);
+	 i++) {
+	delay(1);
+    }
+    return i < MAXWAIT;
+#undef MAXWAIT
+} /* reg_wait_STAT_CHARMEM_UNAVAIL() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: reg_write_nowait
+ *  Purpose	: Write a register without checking any conditions.
+ *  Method	: Use SPI.
+ *
+ *  Only use this when the conditions described at reg_write() are known to
+ *  be met, e.g. for subsequent writes in a burst.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+reg_write_nowait(
+    regw_t 	reg,	/* register to write */
+    uint8_t 	value)	/* value to write */
+{
+    SPI.transfer(reg);
+    SPI.transfer(value);
+} /* reg_write_nowait() */
+
+
 /*------------------------------------------------------------------------
  *  Function	: reg_write
  *  Purpose	: Write a register.
@@ -235,12 +327,7 @@ reg_write(
     int i;		/* number of milliseconds we had to wait */
 
     if (reg_check_STAT_CHARMEM_UNAVAIL(reg)) {
-	for (i = 0;
-	     i < MAXWAIT && reg_getbit(R_STAT, STAT_CHARMEM_UNAVAIL);
-	     i++) {
-	    delay(1);
-	}
-	if (i >= MAXWAIT) return false;
+	if (!reg_wait_STAT_CHARMEM_UNAVAIL()) return false;
     }
     if (reg_check_DMM_CLEAR(reg)) {
 	for (i = 0;
@@ -250,8 +337,7 @@ reg_write(
 	}
 	if (i >= MAXWAIT) return false;
     }
-    SPI.transfer(reg);
-    SPI.transfer(value);
+    reg_write_nowait(reg, value);
     return true;
 #undef MAXWAIT
 } /* reg_write() */
@@ -343,10 +429,76 @@ reg_setbit_check(
 } /* reg_setbit_check() */
 
 
+/*------------------------------------------------------------------------
+ *  Function	: vm0_write
+ *  Purpose	: Write register VM0.
+ *  Method	: Write given value, remember it for the next write.
+ *
+ *  Keeping the value avoids a read-modify-write cycle per bit to change.
+ *  The chip must be selected by the caller.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+vm0_write(
+    uint8_t 	val)	/* value to write */
+{
+    reg_write(W_VM0, val);
+    vm0val = val;
+} /* vm0_write() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: vm0_check
+ *  Purpose	: Verify the enable bit of register VM0, restore if needed.
+ *  Method	: Read VM0 once, write it back only when the bit is wrong.
+ *
+ *  The chip must be selected by the caller. A restore is only counted when
+ *  the bit was lost, not when the requested state has changed. The check
+ *  interval is reset after any write and doubled otherwise.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+static bool
+vm0_check(
+    bool 	enable)		/* whether to enable */
+{
+    uint8_t 	val;		/* register value */
+    bool 	result = true;	/* return value */
+
+    val = reg_read(R_VM0);
+    vm0val = val;
+    vm0checks++;
+    if (((val & (0x01 << VM0_ENABLE)) != 0) != enable) {
+	if (enable == vm0enable) vm0restores++;
+	if (enable) {
+	    val |= (0x01 << VM0_ENABLE);
+	} else {
+	    val &= ~(0x01 << VM0_ENABLE);
+	}
+	result = reg_write_check(W_VM0, val);
+	vm0val = val;
+	vm0interval = VM0CHECK_MIN;
+    } else if (vm0interval < VM0CHECK_MAX) {
+	vm0interval *= 2;
+    }
+    vm0enable = enable;
+    vm0last = millis();
+    return result;
+} /* vm0_check() */
+
+
 /*------------------------------------------------------------------------
  *  Function	: max_refreshscreen
  *  Purpose	: Write the shadow screenbuffer to screen.
- *  Method	: Use 16 bit-mode and no auto-increment.
+ *  Method	: Use 16 bit-mode and no auto-increment. Set the DMM
+ *  		  attributes when they differ from the previous character.
+ *
+ *  At most REFRESHMAX characters are written per call (0 is unlimited).
+ *  The next call then resumes at the first character left dirty, see
+ *  refreshpart.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
@@ -356,6 +508,10 @@ max_refreshscreen()
 {
     uint16_t	 pos; 		/* screenbuf position */
     uint16_t	 highpos;	/* highest screen position + 1 */
+    uint8_t	 attr = ATTR_NORMAL;	/* attributes set in DMM */
+    bool	 high;		/* whether DMAH bit is set */
+    uint16_t	 budget;	/* number of characters left to write */
+    static uint16_t resume;	/* position to resume partial refresh */
     static bool	 busy;		/* whether we're still busy */
 
     if (!screenbuf.dirty || busy || digitalRead(MAX_SELECTPIN) == LOW) {
@@ -370,6 +526,11 @@ max_refreshscreen()
     busy = true;
     screenbuf.dirty = false;
 
+    /* Piggyback the enable watchdog while the chip is selected anyway. */
+    if (millis() - vm0last >= vm0interval) {
+	vm0_check(cfg_get_enable());
+    }
+
     /*
      * We choose not to use the auto-increment mode although there would be no
      * better example like this. But we'd have to give up char 0xFF which would
@@ -384,17 +545,33 @@ max_refreshscreen()
      * But we use a little trick that seems to hide screen update artefacts.
      * This even runs smoothly without using vsync at all.
      */
-    reg_setbit(W_DMM, DMM_MODE_8BIT, false);   	/* 16 bit operation mode */
-    reg_setbit(W_DMM, DMM_LBC_VIDEOIN, false); 	/* background is video in */
-    reg_setbit(W_DMM, DMM_BLINK, false);   	/* blinking off */
-    reg_setbit(W_DMM, DMM_INVERT, false);	/* invert off */
-    reg_setbit(W_DMAH, 0, false);		/* MSB of display address */
+    /* 16 bit operation mode, background is video in, blink & invert off */
+    reg_write(W_DMM, 0x00);
     highpos = screenbuf.rows * screenbuf.cols;
-    for (pos = 0; pos < highpos; pos++) {
-	if (pos == 0x100) {
-            reg_setbit(W_DMAH, 0, true);	/* MSB of display address */
+    if (!refreshpart || resume >= highpos) resume = 0;
+    high = resume >= 0x100;
+    reg_setbit(W_DMAH, 0, high);		/* MSB of display address */
+    if ((budget = cfg_get_refreshmax()) == 0) budget = highpos;
+    refreshpart = false;
+    for (uint16_t i = 0; i < highpos; i++) {
+	pos = resume + i < highpos ? resume + i : resume + i - highpos;
+	if ((pos >= 0x100) != high) {
+	    high = !high;
+            reg_setbit(W_DMAH, 0, high);	/* MSB of display address */
 	}
 	if (SCREENDIRTY(screenbuf, pos)) {
+	    if (budget-- == 0) {
+		/* Out of budget, resume here upon next vsync. */
+		refreshpart = true;
+		resume = pos;
+		screenbuf.dirty = true;
+		break;
+	    }
+	    if (SCREENATTR(screenbuf, pos) != attr) {
+		attr = SCREENATTR(screenbuf, pos);
+		reg_write(W_DMM, ((attr & ATTR_BLINK) != 0 ? 0x01 << DMM_BLINK : 0)
+			  | ((attr & ATTR_INVERT) != 0 ? 0x01 << DMM_INVERT : 0));
+	    }
 	    reg_write(W_DMAL, pos % 0x100);	/* LSBs of display address */
 	    reg_write(W_DMDI, screenbuf.buf[pos]);
 	    SCREENUNSETDIRTY(screenbuf, pos);
@@ -409,7 +586,17 @@ max_refreshscreen()
 /*------------------------------------------------------------------------
  *  Function	: max_vsync
  *  Purpose	: Vertical sync interrupt handler.
- *  Method	: Print the screen during vertical synchronisation.
+ *  Method	: Track the field time, print the screen during vertical
+ *  		  synchronisation.
+ *
+ *  The field time tells PAL (20 ms) from NTSC (16.7 ms), see vsyncstd. Its
+ *  running average (1/16 weight per field) is used to count missed vsyncs
+ *  and to refresh at the vsync nearest to the REFRESH interval, rather than
+ *  at the first vsync after it.
+ *
+ *  A refresh only starts when the screen is dirty, so REFRESH limits the
+ *  refresh rate but doesn't delay the first change after an idle period.
+ *  A refresh cut short by REFRESHMAX continues upon the next vsync.
  *
  *  Returns	: Nothing.
  *------------------------------------------------------------------------
@@ -418,13 +605,55 @@ static void
 max_vsync(void)
 {
     static unsigned long oldtime = millis();	/* old timestamp */
-    unsigned long thistime;			/* current timestamp */
+    static unsigned long oldfield;		/* old vsync timestamp in us */
+    static uint8_t	 oldstd;		/* standard of old field */
+    unsigned long 	 thistime;		/* current timestamp */
+    unsigned long 	 field;			/* field time in us */
+    uint16_t		 avg;			/* average field time in us */
+    uint16_t		 dev;			/* deviation from average */
+    uint8_t		 std = 0;		/* standard of this field */
+
+    field = micros() - oldfield;
+    oldfield += field;
+    avg = vsyncstats.fieldtime;
+    if (field >= FIELD_PAL_MIN && field <= FIELD_PAL_MAX) {
+	std = 0x01 << STAT_PAL;
+    } else if (field >= FIELD_NTSC_MIN && field <= FIELD_NTSC_MAX) {
+	std = 0x01 << STAT_NTSC;
+    } else if (field >= VSYNC_LOST * 1000UL) {
+	vsyncstats.losses++;
+    } else if (avg != 0 && field > avg * 3UL / 2) {
+	vsyncstats.missed += (field + avg / 2) / avg - 1;
+    }
+    if (std != 0) {
+	if (std == oldstd) {
+	    avg += ((int32_t)field - avg) / 16;
+	    dev = field > avg ? field - avg : avg - field;
+	    if (dev > vsyncstats.jitter) vsyncstats.jitter = dev;
+	} else {
+	    avg = field;	/* (re)start averaging */
+	}
+	vsyncstats.fieldtime = avg;
+	vsyncstats.fields++;
+	if (std == oldstd && std != vsyncstd) {
+	    vsyncstd = std;
+	    vsyncchange = true;
+	}
+    }
+    oldstd = std;
+    vsynclast = millis();
 
     sei();	/* enable other interrupts */
-    if ((thistime = millis()) - oldtime > cfg_get_refresh()) {
+    if (!screenbuf.dirty) return;
+    if (!refreshpart) {
+	thistime = millis();
+	if (thistime - oldtime + (vsyncstats.fieldtime >> 11)
+	    <= cfg_get_refresh()) {
+	    return;
+	}
 	oldtime = thistime;
-        max_refreshscreen();
     }
+    max_refreshscreen();
 } /* max_vsync() */
 
 
@@ -543,6 +772,7 @@ max_cbwl(
 	}
     }
     digitalWrite(MAX_SELECTPIN, HIGH);
+    rbvalid = false;
     return res;
 } /* max_cbwl() */
 
@@ -594,6 +824,7 @@ max_reset(
     digitalWrite(MAX_SELECTPIN, LOW);
     videomode = reg_getbit(R_VM0, VM0_VIDEOSELECT_PAL);
     reg_setbit(W_VM0, VM0_RESET, true);
+    rbvalid = false;
     do {
 	delay(1);	/* typical should be 0.1 ms, wait a little longer */
     } while (reg_getbit(R_STAT, STAT_RESET));
@@ -604,14 +835,14 @@ max_reset(
      * deselect/reselect again. So this will not work while keeping the
      * selectpin LOW.
      */
-    result = max_enable(cfg_get_enable()); /* also done in main loop() */
+    result = max_enable(cfg_get_enable()); /* see also max_watchdog() */
 
     /* Restore PAL/NTSC video mode bit. */
-    digitalWrite(MAX_SELECTPIN, LOW);
-    if (reg_getbit(R_VM0, VM0_VIDEOSELECT_PAL) != videomode) {
-        reg_setbit(W_VM0, VM0_VIDEOSELECT_PAL, videomode);
+    if (((vm0val & (0x01 << VM0_VIDEOSELECT_PAL)) != 0) != videomode) {
+	digitalWrite(MAX_SELECTPIN, LOW);
+	vm0_write(vm0val ^ (0x01 << VM0_VIDEOSELECT_PAL));
+	digitalWrite(MAX_SELECTPIN, HIGH);
     }
-    digitalWrite(MAX_SELECTPIN, HIGH);
 
     /* Refresh screen. */
     for (uint16_t pos = 0; pos < MAXSCRSIZE; pos++) {
@@ -634,24 +865,92 @@ bool
 max_enable(
     bool 	enable)		/* whether to enable */
 {
-    bool 	result = true;	/* return value */
+    bool 	result;		/* return value */
 
+    vm0enable = enable;		/* requested, so no restore */
     digitalWrite(MAX_SELECTPIN, LOW);
-    if (reg_getbit(R_VM0, VM0_ENABLE) != enable) {
-#ifndef NO_DEBUG
-	if (!cfg_get_silent() && cfg_get_debug()) {
-	    Serial.println(F("<Restore VM0 register>"));
-	}
-#endif
-	if (!reg_setbit_check(W_VM0, VM0_ENABLE, enable)) {
-	    result = false;
-	}
-    }
+    result = vm0_check(enable);
     digitalWrite(MAX_SELECTPIN, HIGH);
     return result;
 } /* max_enable() */
 
 
+/*------------------------------------------------------------------------
+ *  Function	: max_watchdog
+ *  Purpose	: Keep the enable flag of register VM0 as configured.
+ *  Method	: Check VM0 when the configuration changed or when the check
+ *  		  interval has passed without a screen refresh doing it.
+ *
+ *  This is cheap to call often, as no SPI transfer is done unless needed.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+max_watchdog(void)
+{
+    bool 	enable = cfg_get_enable();	/* whether to enable */
+    uint16_t 	restores;			/* restores before check */
+    bool 	due;				/* whether check is due */
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {	/* see max_refreshscreen() */
+	restores = vm0restores;
+	due = enable != vm0enable || millis() - vm0last >= vm0interval;
+    }
+    if (!due) return;
+    digitalWrite(MAX_SELECTPIN, LOW);
+    vm0_check(enable);
+    digitalWrite(MAX_SELECTPIN, HIGH);
+#ifndef NO_DEBUG
+    if (restores != vm0restores && !cfg_get_silent() && cfg_get_debug()) {
+	Serial.println(F("<Restore VM0 register>"));
+    }
+#else
+    (void)restores;
+#endif
+} /* max_watchdog() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: max_get_watchdog
+ *  Purpose	: Get enable watchdog statistics.
+ *  Method	: Copy data.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+max_get_watchdog(
+    vm0stats_p	st)	/* statistics */
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {	/* see max_refreshscreen() */
+	st->checks = vm0checks;
+	st->restores = vm0restores;
+	st->interval = vm0interval;
+    }
+} /* max_get_watchdog() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: max_get_vsync
+ *  Purpose	: Get vsync statistics.
+ *  Method	: Copy data, reset max. jitter.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+max_get_vsync(
+    vsyncstats_p	st)	/* statistics */
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {	/* see max_vsync() */
+	*st = vsyncstats;
+	vsyncstats.jitter = 0;
+	if (millis() - vsynclast >= VSYNC_LOST) st->fieldtime = 0;
+    }
+} /* max_get_vsync() */
+
+
 /*------------------------------------------------------------------------
  *  Function	: max_regsetget
  *  Purpose	: Get a register set to store (possibly to eeprom).
@@ -667,7 +966,8 @@ max_regsetget(
     if (regset == NULL) return false;
     digitalWrite(MAX_SELECTPIN, LOW);
     for (uint8_t i = 0; i < REGW_COUNT; i++) {
-        regset->values[i] = reg_read(W2R(REGSAVE[i].reg));
+        regset->values[i] =
+	    reg_read(W2R((regw_t)pgm_read_byte(&REGSAVE[i].reg)));
     }
     digitalWrite(MAX_SELECTPIN, HIGH);
     return true;
@@ -691,11 +991,14 @@ max_regsetput(
     if (regset == NULL) return false;
     digitalWrite(MAX_SELECTPIN, LOW);
     for (uint8_t i = 0; ok && i < REGW_COUNT; i++) {
-	if (REGSAVE[i].restore_from_eeprom) {
-            ok = ok && reg_write_check(REGSAVE[i].reg, regset->values[i]);
+	if (pgm_read_byte(&REGSAVE[i].restore_from_eeprom)) {
+            ok = ok && reg_write_check(
+		(regw_t)pgm_read_byte(&REGSAVE[i].reg), regset->values[i]);
 	}
     }
+    vm0val = reg_read(R_VM0);
     digitalWrite(MAX_SELECTPIN, HIGH);
+    rbvalid = false;
     return ok;
 } /* max_regsetput() */
 
@@ -703,7 +1006,13 @@ max_regsetput(
 /*------------------------------------------------------------------------
  *  Function	: max_fontcharget
  *  Purpose	: Read font character from EEPROM.
- *  Method	:
+ *  Method	: Disable OSD, let the chip copy the character from NVM to
+ *  		  its shadow RAM, read shadow RAM in a burst.
+ *
+ *  The character memory is only busy while the chip copies from NVM to
+ *  shadow RAM. So we wait for that once instead of polling the STAT register
+ *  before every single byte. Note that the Max7456 has no auto-increment for
+ *  character memory; each byte still needs its CMAL address write.
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
@@ -713,31 +1022,39 @@ max_fontcharget(
     uint8_t	num,	/* number of character to get [0..255] */
     fontbuf_t 	*buf)	/* font character buffer */
 {
+    bool	result;	/* return value */
+
     digitalWrite(MAX_SELECTPIN, LOW);
-    reg_setbit(W_VM0, VM0_ENABLE, false);
-    reg_write(W_CMAH, num);
-    reg_write(W_CMM, 0x5F);
+    vm0_write(vm0val & ~(0x01 << VM0_ENABLE));	/* waits for STAT */
+    reg_write_nowait(W_CMAH, num);
+    reg_write_nowait(W_CMM, 0x5F);
+    if ((result = reg_wait_STAT_CHARMEM_UNAVAIL())) {
 
-    /*
-     * Note that because buf is a pointer to fontbuf_t data, sizeof(*buf) gives
-     * the correct number of bytes. sizeof(buf) with a fontbuf_t typed buf
-     * would return the size of a pointer. This is only true when passed as a
-     * function parameter like here.
-     */
-    for (uint16_t i = 0; i < sizeof(*buf); i++) {
-	reg_write(W_CMAL, (uint8_t)i);
-	(*buf)[i] = reg_read(R_CMDO);
+	/*
+	 * Note that because buf is a pointer to fontbuf_t data, sizeof(*buf)
+	 * gives the correct number of bytes. sizeof(buf) with a fontbuf_t
+	 * typed buf would return the size of a pointer. This is only true
+	 * when passed as a function parameter like here.
+	 */
+	for (uint16_t i = 0; i < sizeof(*buf); i++) {
+	    reg_write_nowait(W_CMAL, (uint8_t)i);
+	    (*buf)[i] = reg_read(R_CMDO);
+	}
     }
-    reg_setbit(W_VM0, VM0_ENABLE, true);
+    vm0_write(vm0val | (vm0enable ? (0x01 << VM0_ENABLE) : 0x00));
     digitalWrite(MAX_SELECTPIN, HIGH);
-    return true;
+    return result;
 } /* max_fontcharget() */
 
 
 /*------------------------------------------------------------------------
  *  Function	: max_fontcharput
  *  Purpose	: Save font character into EEPROM.
- *  Method	: 
+ *  Method	: Disable OSD, write shadow RAM in a burst, let the chip copy
+ *  		  shadow RAM to NVM.
+ *
+ *  Writing the shadow RAM doesn't make the character memory busy, so only
+ *  the final NVM write has to be waited for. See also max_fontcharget().
  *
  *  Returns	: Indication of success.
  *------------------------------------------------------------------------
@@ -747,9 +1064,11 @@ max_fontcharput(
     uint8_t	num,	/* number of character to put [0 .. 255] */
     fontbuf_t 	*buf)	/* font character buffer */
 {
+    bool	result;	/* return value */
+
     digitalWrite(MAX_SELECTPIN, LOW);
-    reg_setbit(W_VM0, VM0_ENABLE, false);
-    reg_write(W_CMAH, num);
+    vm0_write(vm0val & ~(0x01 << VM0_ENABLE));	/* waits for STAT */
+    reg_write_nowait(W_CMAH, num);
 
     /*
      * Note that because buf is a pointer to fontbuf_t data, sizeof(*buf) gives
@@ -758,20 +1077,28 @@ max_fontcharput(
      * function parameter like here.
      */
     for (uint16_t i = 0; i < sizeof(*buf); i++) {
-	reg_write(W_CMAL, (uint8_t)i);
-	reg_write(W_CMDI, (*buf)[i]);
+	reg_write_nowait(W_CMAL, (uint8_t)i);
+	reg_write_nowait(W_CMDI, (*buf)[i]);
     }
-    reg_write(W_CMM, 0xAF);
-    reg_setbit(W_VM0, VM0_ENABLE, true);
+    reg_write_nowait(W_CMM, 0xAF);
+    result = reg_wait_STAT_CHARMEM_UNAVAIL();
+    vm0_write(vm0val | (vm0enable ? (0x01 << VM0_ENABLE) : 0x00));
     digitalWrite(MAX_SELECTPIN, HIGH);
-    return true;
+    return result;
 } /* max_fontcharput() */
 
 
 /*------------------------------------------------------------------------
  *  Function	: max_videodetect
  *  Purpose	: Detect PAL or NTSC video input, and loss-of-sync.
- *  Method	: Keep track of last known values.
+ *  Method	: Read STAT once, act on bits that became set since the last
+ *  		  read.
+ *
+ *  STAT is only read when the vsync field time has changed, when vsync
+ *  pulses are missing, or when VDETECT ms have passed. A VDETECT of 0 stops
+ *  the periodic reads, leaving detection to the field time alone. After a
+ *  field time change, STAT is read again for a few calls until the chip
+ *  reports the new standard too.
  *
  *  Returns	: Nothing.
  *------------------------------------------------------------------------
@@ -779,9 +1106,29 @@ max_fontcharput(
 void
 max_videodetect(void)
 {
-    static bool pal_detected = false;	/* whether PAL signal detected */
-    static bool ntsc_detected = false;	/* whether NTSC signal detected */
-    static bool los_detected = false;   /* whether loss-of-sync detected */
+#define STAT_MASK ((0x01 << STAT_PAL) | (0x01 << STAT_NTSC) | (0x01 << STAT_LOS))
+
+    static uint8_t	 stat;		/* last known STAT bits */
+    static unsigned long oldtime;	/* timestamp of last STAT read */
+    static uint8_t	 retries;	/* reads left after vsync change */
+    unsigned long	 thistime = millis();	/* current timestamp */
+    unsigned long	 vdetect = cfg_get_vdetect();	/* poll period in ms */
+    unsigned long	 lastvsync;	/* timestamp of last vsync */
+    uint8_t		 std;		/* standard of vsync field time */
+    uint8_t		 val;		/* current STAT bits */
+    uint8_t		 edges;		/* STAT bits that became set */
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {	/* see max_vsync() */
+	if (vsyncchange) retries = VDETECT_RETRY;
+	vsyncchange = false;
+	std = vsyncstd;
+	lastvsync = vsynclast;
+    }
+    if (retries == 0 && thistime - lastvsync < VSYNC_LOST
+	&& (vdetect == 0 || thistime - oldtime < vdetect)) {
+	return;
+    }
+    oldtime = thistime;
 
     /*
      * There's no need to refresh the screen when switching between PAL and
@@ -790,38 +1137,35 @@ max_videodetect(void)
      * NTSC will have three lines less.
      */
     digitalWrite(MAX_SELECTPIN, LOW);
-    if (pal_detected != reg_getbit(R_STAT, STAT_PAL)) {
-	if ((pal_detected = !pal_detected)) {
-	    reg_setbit(W_VM0, VM0_VIDEOSELECT_PAL, true);
-	    screenbuf.rows = PALROWS;
-#ifndef NO_DEBUG
-            if (!cfg_get_silent() && cfg_get_debug()) {
-                Serial.println(F("<PAL detected>"));
-	    }
-#endif
-	}
+    val = reg_read(R_STAT) & STAT_MASK;
+    edges = val & ~stat;
+    stat = val;
+    if (retries > 0) {
+	retries = (val & std) != 0 ? 0 : retries - 1;
     }
-    if (ntsc_detected != reg_getbit(R_STAT, STAT_NTSC)) {
-	if ((ntsc_detected = !ntsc_detected)) {
-	    reg_setbit(W_VM0, VM0_VIDEOSELECT_PAL, false);
-	    screenbuf.rows = NTSCROWS;
-#ifndef NO_DEBUG
-            if (!cfg_get_silent() && cfg_get_debug()) {
-	        Serial.println(F("<NTSC detected>"));
-	    }
-#endif
-	}
+    if ((edges & (0x01 << STAT_PAL)) != 0) {
+	vm0_write(vm0val | (0x01 << VM0_VIDEOSELECT_PAL));
+	screenbuf.rows = PALROWS;
     }
-    if (los_detected != reg_getbit(R_STAT, STAT_LOS)) {
-	if ((los_detected = !los_detected)) {
+    if ((edges & (0x01 << STAT_NTSC)) != 0) {
+	vm0_write(vm0val & ~(0x01 << VM0_VIDEOSELECT_PAL));
+	screenbuf.rows = NTSCROWS;
+    }
+    digitalWrite(MAX_SELECTPIN, HIGH);
 #ifndef NO_DEBUG
-            if (!cfg_get_silent() && cfg_get_debug()) {
-	        Serial.println(F("<Loss-of-sync detected>"));
-	    }
-#endif
+    if (!cfg_get_silent() && cfg_get_debug()) {
+	if ((edges & (0x01 << STAT_PAL)) != 0) {
+	    Serial.println(F("<PAL detected>"));
+	}
+	if ((edges & (0x01 << STAT_NTSC)) != 0) {
+	    Serial.println(F("<NTSC detected>"));
+	}
+	if ((edges & (0x01 << STAT_LOS)) != 0) {
+	    Serial.println(F("<Loss-of-sync detected>"));
 	}
     }
-    digitalWrite(MAX_SELECTPIN, HIGH);
+#endif
+#undef STAT_MASK
 } /* max_videodetect() */
 
 
@@ -979,3 +1323,66 @@ max_cwl(
  */
     return max_cbwl(line, num, 0x00, 0x03, 0, 1);
 } /* max_cwl() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: max_rowlevel
+ *  Purpose	: Set character black/white level of a range of rows.
+ *  Method	: Interpolate levels per row, write changed Row N Brightness
+ *  		  registers (RB0-RB15) in one go, using cached values.
+ *
+ *  The levels go linearly from black0/white0 at the first row to
+ *  black1/white1 at the last row, so equal levels give a uniform range
+ *  and different levels give a fade. A negative level keeps the current
+ *  value of all rows. Levels are as described at max_cbl() and max_cwl().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+max_rowlevel(
+    int16_t 	first,	/* first row */
+    int16_t 	last,	/* last row */
+    int16_t 	black0,	/* black level at first row, < 0 to keep */
+    int16_t 	white0,	/* white level at first row, < 0 to keep */
+    int16_t 	black1,	/* black level at last row */
+    int16_t 	white1)	/* white level at last row */
+{
+    uint8_t 	n;	/* number of row steps */
+    uint8_t 	k;	/* row step */
+    uint8_t 	val;	/* new register value */
+
+    if (first < 0 || last >= ROWCOUNT || first > last) return false;
+    if (black0 > 3 || white0 > 3 || black1 > 3 || white1 > 3) return false;
+    if ((black0 < 0) != (black1 < 0) || (white0 < 0) != (white1 < 0)) {
+	return false;
+    }
+    n = last - first;
+    digitalWrite(MAX_SELECTPIN, LOW);
+    if (!rbvalid) {
+	for (uint8_t i = 0; i < ROWCOUNT; i++) {
+	    rbcache[i] = reg_read(W2R(W_RB0 + i));
+	}
+	rbvalid = true;
+    }
+    for (uint8_t row = first; row <= last; row++) {
+	k = row - first;
+	val = rbcache[row];
+	if (black0 >= 0) {
+	    val &= ~0x0C;
+	    val |= (n == 0 ? black0
+		    : (2 * (black0 * (n - k) + black1 * k) + n) / (2 * n)) << 2;
+	}
+	if (white0 >= 0) {
+	    val &= ~0x03;
+	    val |= (n == 0 ? white0
+		    : (2 * (white0 * (n - k) + white1 * k) + n) / (2 * n));
+	}
+	if (val != rbcache[row]) {
+	    reg_write_nowait((regw_t)(W_RB0 + row), val);
+	    rbcache[row] = val;
+	}
+    }
+    digitalWrite(MAX_SELECTPIN, HIGH);
+    return true;
+} /* max_rowlevel() */
@@ -93,6 +93,13 @@ extern regset_t DEFREGVALS;		/* default register values */
 #define MAXCOLS (30)			/* maximum number of screen columns */
 #define MAXSCRSIZE (MAXROWS * MAXCOLS)  /* maximum screen buffer size */
 #define MAXDIRTSIZE (MAXSCRSIZE/8 + 1)	/* maximum dirt size */
+#define MAXATTRSIZE (MAXSCRSIZE/4)	/* maximum attribute size */
+
+/* Character attributes, 2 bits per character in screenbuf. */
+#define ATTR_NORMAL	(0x00)		/* white on video */
+#define ATTR_BLINK	(0x01)		/* blinking */
+#define ATTR_INVERT	(0x02)		/* black and white swapped */
+#define ATTR_MASK	(0x03)		/* all attributes */
 
 #define SCREENDIRTY(screenbuf, pos) 				\
     ((screenbuf).dirt[(pos) / 8] & (0x01 << ((pos) % 8)))
@@ -107,21 +114,60 @@ extern regset_t DEFREGVALS;		/* default register values */
     (screenbuf).dirt[(pos) / 8] &= ~(0x01 << ((pos) % 8));	\
 }
 
-#define SCREENSET(screenbuf, pos, val) 				\
+#define SCREENATTR(screenbuf, pos) 				\
+    (((screenbuf).attr[(pos) / 4] >> (2 * ((pos) % 4))) & ATTR_MASK)
+
+#define SCREENSETATTR(screenbuf, pos, val, at) 			\
 {								\
     (screenbuf).buf[(pos)] = (val);				\
+    (screenbuf).attr[(pos) / 4] = ((screenbuf).attr[(pos) / 4]	\
+	& ~(ATTR_MASK << (2 * ((pos) % 4))))			\
+	| (((at) & ATTR_MASK) << (2 * ((pos) % 4)));		\
     SCREENSETDIRTY((screenbuf), (pos));				\
     (screenbuf).dirty = true;					\
 }
 
+#define SCREENSET(screenbuf, pos, val) 				\
+    SCREENSETATTR((screenbuf), (pos), (val), ATTR_NORMAL)
+
+#define SCREENSETBLINK(screenbuf, pos, val) 			\
+    SCREENSETATTR((screenbuf), (pos), (val), ATTR_BLINK)
+
+/* Set only when value or attribute differs, to avoid needless refresh. */
+#define SCREENUPDATEATTR(screenbuf, pos, val, at) 		\
+{								\
+    if ((screenbuf).buf[(pos)] != (val)				\
+	|| SCREENATTR((screenbuf), (pos)) != (at)) {		\
+	SCREENSETATTR((screenbuf), (pos), (val), (at));		\
+    }								\
+}
+
+#define SCREENUPDATE(screenbuf, pos, val) 			\
+    SCREENUPDATEATTR((screenbuf), (pos), (val), ATTR_NORMAL)
+
 typedef struct screenbuf_t {		/* shadow screenbuffer */
     char 	buf[MAXSCRSIZE];	/* buffer contents */
     uint8_t 	dirt[MAXDIRTSIZE];	/* dirty flag for each char in buf */
+    uint8_t 	attr[MAXATTRSIZE];	/* attributes of each char in buf */
     int		rows;			/* number of rows */
     int 	cols;			/* number of columns */
     bool 	dirty;			/* whether screen needs redrawing */
 } screenbuf_t, *screenbuf_p;
 
+typedef struct vm0stats_t {		/* enable watchdog statistics */
+    uint16_t	checks;			/* number of VM0 checks */
+    uint16_t	restores;		/* number of enable bit restores */
+    uint16_t	interval;		/* current check interval in ms */
+} vm0stats_t, *vm0stats_p;
+
+typedef struct vsyncstats_t {		/* vsync statistics */
+    uint16_t	fieldtime;		/* average field time in us */
+    uint16_t	jitter;			/* max. deviation from average in us */
+    uint32_t	fields;			/* number of PAL/NTSC fields seen */
+    uint16_t	missed;			/* number of missed vsyncs */
+    uint16_t	losses;			/* number of vsync losses (>100 ms) */
+} vsyncstats_t, *vsyncstats_p;
+
 /*
  * A functional interface costs a lot (stack space & handling) but would be
  * clean. however, the interrupt handler that calls a function that uses a
@@ -136,6 +182,12 @@ bool max_reset(bool);
 
 bool max_enable(bool);
 
+void max_watchdog(void);
+
+void max_get_watchdog(vm0stats_p);
+
+void max_get_vsync(vsyncstats_p);
+
 bool max_regsetget(regset_t *);
 
 bool max_regsetput(regset_t *);
@@ -158,6 +210,8 @@ int8_t max_cbl(int8_t, int16_t);
 
 int8_t max_cwl(int8_t, int16_t);
 
+bool max_rowlevel(int16_t, int16_t, int16_t, int16_t, int16_t, int16_t);
+
 bool max_refreshscreen();
 
 #endif /* MAX7456_H */
@@ -24,6 +24,10 @@
  *========================================================================
  */
 
+#include <Arduino.h>
+#include <stdint.h>
+#include "misc.h"
+
 
 /*------------------------------------------------------------------------
  *  Function	: freemem
@@ -44,3 +48,47 @@ freemem(void)
 } /* freemem() */
 
 
+/*------------------------------------------------------------------------
+ *  Function	: fixtostrf
+ *  Purpose	: Convert fixed-point value to string.
+ *  Method	: Write digits backwards, insert decimal point, pad.
+ *
+ *  This is the integer counterpart of dtostrf(); e.g. value 1234 with 2
+ *  decimals gives "12.34". A negative width aligns the string to the left,
+ *  like dtostrf() does. The buffer should be large enough to hold the
+ *  result, including the terminating NUL-byte.
+ *
+ *  Returns	: Pointer to the converted string.
+ *------------------------------------------------------------------------
+ */
+char *
+fixtostrf(
+    int32_t	val,	/* value in units of 10^-prec */
+    int8_t	width,	/* minimum field width */
+    uint8_t	prec,	/* number of decimals */
+    char	*buf)	/* output buffer */
+{
+    char	tmp[14];	/* digits in reverse order */
+    uint8_t	n = 0;		/* number of characters in tmp */
+    uint8_t	i = 0;		/* index in buf */
+    uint32_t	uval;		/* absolute value */
+    bool	left;		/* whether to align left */
+
+    uval = val < 0 ? -(uint32_t)val : (uint32_t)val;
+    do {
+	if (n == prec && prec > 0) tmp[n++] = '.';
+	tmp[n++] = '0' + uval % 10;
+	uval /= 10;
+    } while (uval > 0 || n <= prec);
+    if (val < 0) tmp[n++] = '-';
+    if ((left = (width < 0))) width = -width;
+    if (!left) {
+	while (width-- > n) buf[i++] = ' ';
+    }
+    while (n > 0) buf[i++] = tmp[--n];
+    if (left) {
+	while (i < width) buf[i++] = ' ';
+    }
+    buf[i] = '\0';
+    return buf;
+} /* fixtostrf() */
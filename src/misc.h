@@ -29,5 +29,7 @@
 
 int freemem(void);
 
+char *fixtostrf(int32_t, int8_t, uint8_t, char *);
+
 #endif /* MISC_H */
 
@@ -131,16 +131,16 @@ request(void)
 #define INIT() \
     init_parse(silent, control_msg, control_chr, &parse, &sent_soh);
 #define ACK(msg) \
-    send_control((msg), (byte)CONTROL_ACK, silent, control_msg, control_chr);
+    send_control(F(msg), (byte)CONTROL_ACK, silent, control_msg, control_chr);
 #define NAK(msg) \
-    send_control((msg), (byte)CONTROL_NAK, silent, control_msg, control_chr);
+    send_control(F(msg), (byte)CONTROL_NAK, silent, control_msg, control_chr);
 
 #ifndef NO_DEBUG
 #define DEBUG_FREEMEM()				\
 {						\
     if (cfg_get_debug()) {			\
 	Serial.print(freemem());		\
-	Serial.print(" ");			\
+	Serial.print(F(" "));			\
     }						\
 }
 #else
@@ -250,7 +250,7 @@ serial_request_init2(void)
  */
 static void
 send_control(
-	const char 	*msg,		/* control msg to print to serial */
+	const __FlashStringHelper *msg,	/* control msg to print to serial */
 	byte		chr,		/* control char to print to serial */
 	bool 		silent,		/* whether to be silent */
     	bool		control_msg,	/* whether to send control message */
@@ -268,6 +268,47 @@ send_control(
 } /* send_control() */
 
 
+/*------------------------------------------------------------------------
+ *  Function	: send_report
+ *  Purpose	: Send subscribed sensor values to serial.
+ *  Method	: Write to serial if any sensor needs to be reported.
+ *
+ *  Reports are sent only between responses, so they can't be confused with
+ *  command output. Each value is written as <sensor-id>:<voltage>,
+ *  separated by spaces and enclosed by STX and ETX.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+send_report(
+    	bool		control_msg,	/* whether to send control message */
+	bool 		control_chr)	/* whether to send control chars */
+{
+    int32_t 	mv[SENSOR_COUNT];	/* sensor values */
+    uint8_t 	mask;			/* sensors to report */
+    char	buf[12];		/* print buffer */
+    bool	first = true;		/* whether first value */
+
+    if ((mask = sensor_report(mv)) == 0) return;
+    if (control_msg) Serial.println();
+    if (control_chr) Serial.write((byte)CONTROL_STX);
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+	if ((mask & (1 << i)) == 0) continue;
+	if (!first) Serial.write(' ');
+	Serial.print(i);
+	Serial.write(':');
+	Serial.print(fixtostrf((mv[i] + 5) / 10, 0, 2, buf));
+	first = false;
+    }
+    if (control_chr) Serial.write((byte)CONTROL_ETX);
+    if (control_msg) {
+	Serial.println();
+	Serial.print(F("GSOSD>"));
+    }
+} /* send_report() */
+
+
 /*------------------------------------------------------------------------
  *  Function	: serial_request
  *  Purpose	: Handle serial request if any.
@@ -299,7 +340,7 @@ serial_request(void)
     static uint16_t 		di;		/* data index */
     static parse_t		parse;		/* current parser state */
     static int32_t		len_pending;	/* num of data bytes pending */
-    static cmdprops_p		cmdprops;	/* command properties */
+    static cmdprops_t		cmdprops;	/* command properties */
     static uint8_t		argi;		/* command argument index */
     static int32_t		args[NARGS];	/* command arguments */
     static unsigned long 	time;		/* current time */
@@ -406,8 +447,8 @@ serial_request(void)
 	            INIT();
 		    break;
 		}
-		cmdprops = &CMD_PROPS[j];
-		if (cmdprops->argc > NARGS) {
+		memcpy_P(&cmdprops, &CMD_PROPS[j], sizeof(cmdprops));
+		if (cmdprops.argc > NARGS) {
 		    i = 0;
 		    NAK(MSG_E_INTERNAL);
 	            INIT();
@@ -417,12 +458,12 @@ serial_request(void)
 		for (j = 0; j < NARGS; j++) {
 		    args[j] = 0;
 		}
-		if (cmdprops->argc != 0) {
+		if (cmdprops.argc != 0) {
 		    parse = PARSE_ARG;
-		} else if (cmdprops->use_data) {
+		} else if (cmdprops.use_data) {
 		    parse = PARSE_LEN;
 		} else {
-		    if (!cmdprops->command(NULL)) {
+		    if (!cmdprops.command(NULL)) {
 			NAK(MSG_E_FAIL);
 			/* fallthrough */
 		    } else ACK(MSG_OK);
@@ -455,13 +496,13 @@ serial_request(void)
 		}
 		args[argi++] = intval;
 		i = 0;
-		if (argi < cmdprops->argc) {
+		if (argi < cmdprops.argc) {
 		    parse = PARSE_ARG;
 		} else {
-		    if (cmdprops->use_data) {
+		    if (cmdprops.use_data) {
 		        parse = PARSE_LEN;
 		    } else {
-			if (!cmdprops->command(args)) {
+			if (!cmdprops.command(args)) {
 			    NAK(MSG_E_FAIL);
 			    /* fallthrough */
 		    	} else ACK(MSG_OK);
@@ -499,7 +540,7 @@ serial_request(void)
 		i++;
 	    }
             if (i == sizeof(buf)) {
-	        if (!cmdprops->command(args, di, sizeof(buf), buf)) {
+	        if (!cmdprops.command(args, di, sizeof(buf), buf)) {
 		    NAK(MSG_E_FAIL);
 		    time = 0;
 		    i = 0;
@@ -512,7 +553,7 @@ serial_request(void)
 	    if (len_pending >= 0 && --len_pending <= 0) {
 	        if (i != 0) {
 		    /* flush buffer */
-		    if (!cmdprops->command(args, di, i, buf)) {
+		    if (!cmdprops.command(args, di, i, buf)) {
 		        NAK(MSG_E_FAIL);
 			time = 0;
 			i = 0;
@@ -536,7 +577,7 @@ serial_request(void)
 
     /* flush buffer */
     if (parse == PARSE_DATA && i != 0) {
-	if (!cmdprops->command(args, di, i, buf)) {
+	if (!cmdprops.command(args, di, i, buf)) {
 	    NAK(MSG_E_FAIL);
 	    time = 0;
 	    INIT();
@@ -551,6 +592,11 @@ serial_request(void)
 	Serial.write((byte)CONTROL_DC1);
 	sent_pause = false;
     }
+
+    /* send subscribed sensor values while idle */
+    if (!silent && parse == PARSE_INIT && i == 0 && !sent_soh) {
+	send_report(control_msg, control_chr);
+    }
 } /* serial_request() */
 
 #else
@@ -560,79 +606,268 @@ serial_request(void)
  *------------------------------------------------------------------------
  */
 
-/* A list of all menu items.      				*/
-/* key			name					*/
-#define MENUITEM_TABLE						\
-X(MI_YES,		"Yes")					\
-X(MI_NO,		"No")					\
-X(MI_PLUS,		"+")					\
-X(MI_MINUS,		"-")					\
-X(MI_HORIZONTAL,	"Horizontal")				\
-X(MI_VERTICAL,		"Vertical")				\
-X(MI_VISIBLE,		"Visible")				\
-X(MI_INVISIBLE,		"Invisible")				\
-X(MI_SENSOR0,		"Sensor0")				\
-X(MI_SENSOR1,		"Sensor1")				\
-X(MI_SENSOR2,		"Sensor2")				\
-X(MI_SENSOR3,		"Sensor3")				\
-X(MI_RUNTIME,		"Runtime")				\
-X(MI_ENABLE,		"Enable")				\
-X(MI_HOS,            	"Horizontal offset")			\
-X(MI_VOS,            	"Vertical offset")			\
-X(MI_CBL,            	"Character black level")		\
-X(MI_CWL,            	"Character white level")		\
-X(MI_INSMUX1,        	"Sharpness 1")				\
-X(MI_INSMUX2,        	"Sharpness 2")				\
-X(MI_FONT,        	"Font")					\
-X(MI_FONTEFFECT,       	"Font effect")				\
-X(MI_BORDER,   		"Black border")				\
-X(MI_SHADOW,   		"Shadow")				\
-X(MI_TRANSWHITE,     	"Trans/white")				\
-X(MI_BLACKWHITE,     	"Black/white")				\
-X(MI_INVERT,     	"Invert")				\
-X(MI_FONTRESET,        	"Font reset")				\
-X(MI_LAYOUT,		"Layout")				\
-X(MI_CALIBRATION,	"Calibration")				\
-X(MI_SCREEN,		"Screen")				\
-X(MI_ABOUT,		"About")				\
-X(MI_EMPTY,		"")					\
-X(MI_NONE,		"")					\
+typedef enum menutype_t {	/* menu item types */
+    MT_MENU,			/* plain menu */
+    MT_ELEMENT,			/* layout element, data: element index */
+    MT_SHOW,			/* element visibility, data: visible */
+    MT_AXIS,			/* element position, data: axis index */
+    MT_CALIBRATE,		/* sensor calibration, data: sensor id */
+    MT_REGISTER,		/* screen register, data: register index */
+    MT_ENABLE,			/* OSD image enable */
+    MT_FONTRESET,		/* font reset */
+    MT_FONTEFFECT,		/* font effect, data: effect */
+    MT_STEP,			/* plus/minus, data: 0 plus, 1 minus */
+    MT_CONFIRM,			/* yes/no, data: 1 yes, 0 no */
+    MT_ABOUT,			/* show version */
+} menutype_t;
+
+/*
+ * A list of all menu items. Each item has a type that determines what it
+ * does, some type specific data and a list of sub-items (NULL for leaves).
+ * Sub-item lists are defined below; they can be shared by several items.
+ * The items in a path from the root to the active item together determine
+ * what is adjusted, see adjust_element().
+ */
+/* key			name		type	      data	     children */
+#define MENUITEM_TABLE							      \
+X(MI_EMPTY,		"",		MT_MENU,      0,	     M_MAIN)  \
+X(MI_LAYOUT,		"Layout",	MT_MENU,      0,	     M_LAYOUT)\
+X(MI_CALIBRATION,	"Calibration",	MT_MENU,      0,	     M_CALIB) \
+X(MI_SCREEN,		"Screen",	MT_MENU,      0,	     M_SCREEN)\
+X(MI_ABOUT,		"About",	MT_ABOUT,     0,	     NULL)    \
+X(MI_LAYSENSOR0,	"Sensor0",	MT_ELEMENT,   EL_SENSOR0,    M_SHOW)  \
+X(MI_LAYSENSOR1,	"Sensor1",	MT_ELEMENT,   EL_SENSOR1,    M_SHOW)  \
+X(MI_LAYSENSOR2,	"Sensor2",	MT_ELEMENT,   EL_SENSOR2,    M_SHOW)  \
+X(MI_LAYSENSOR3,	"Sensor3",	MT_ELEMENT,   EL_SENSOR3,    M_SHOW)  \
+X(MI_RUNTIME,		"Runtime",	MT_ELEMENT,   EL_RUNTIME,    M_SHOW)  \
+X(MI_CONSUMPTION,	"Consumption",	MT_ELEMENT,   EL_CONSUMPTION,M_SHOW)  \
+X(MI_PERCENT,		"Percent",	MT_MENU,      0,	     M_PERCENT)\
+X(MI_BAR,		"Bar graph",	MT_MENU,      0,	     M_BAR)   \
+X(MI_PCTSENSOR0,	"Sensor0",	MT_ELEMENT,   EL_PERCENT0,   M_SHOW)  \
+X(MI_PCTSENSOR1,	"Sensor1",	MT_ELEMENT,   EL_PERCENT1,   M_SHOW)  \
+X(MI_PCTSENSOR2,	"Sensor2",	MT_ELEMENT,   EL_PERCENT2,   M_SHOW)  \
+X(MI_PCTSENSOR3,	"Sensor3",	MT_ELEMENT,   EL_PERCENT3,   M_SHOW)  \
+X(MI_BARSENSOR0,	"Sensor0",	MT_ELEMENT,   EL_BAR0,	     M_SHOW)  \
+X(MI_BARSENSOR1,	"Sensor1",	MT_ELEMENT,   EL_BAR1,	     M_SHOW)  \
+X(MI_BARSENSOR2,	"Sensor2",	MT_ELEMENT,   EL_BAR2,	     M_SHOW)  \
+X(MI_BARSENSOR3,	"Sensor3",	MT_ELEMENT,   EL_BAR3,	     M_SHOW)  \
+X(MI_VISIBLE,		"Visible",	MT_SHOW,      true,	     M_AXIS)  \
+X(MI_INVISIBLE,		"Invisible",	MT_SHOW,      false,	     NULL)    \
+X(MI_HORIZONTAL,	"Horizontal",	MT_AXIS,      0,	     M_STEP)  \
+X(MI_VERTICAL,		"Vertical",	MT_AXIS,      1,	     M_STEP)  \
+X(MI_CALSENSOR0,	"Sensor0",	MT_CALIBRATE, SENSOR0,	     M_STEP)  \
+X(MI_CALSENSOR1,	"Sensor1",	MT_CALIBRATE, SENSOR1,	     M_STEP)  \
+X(MI_CALSENSOR2,	"Sensor2",	MT_CALIBRATE, SENSOR2,	     M_STEP)  \
+X(MI_CALSENSOR3,	"Sensor3",	MT_CALIBRATE, SENSOR3,	     M_STEP)  \
+X(MI_ENABLE,		"Enable",	MT_ENABLE,    0,	     M_YESNO) \
+X(MI_HOS,		"Horizontal offset", MT_REGISTER, SR_HOS,    M_STEP)  \
+X(MI_VOS,		"Vertical offset", MT_REGISTER, SR_VOS,	     M_STEP)  \
+X(MI_CBL,		"Character black level", MT_REGISTER, SR_CBL, M_STEP) \
+X(MI_CWL,		"Character white level", MT_REGISTER, SR_CWL, M_STEP) \
+X(MI_INSMUX1,		"Sharpness 1",	MT_REGISTER,  SR_INSMUX1,    M_STEP)  \
+X(MI_INSMUX2,		"Sharpness 2",	MT_REGISTER,  SR_INSMUX2,    M_STEP)  \
+X(MI_FONT,		"Font",		MT_MENU,      0,	     M_FONT)  \
+X(MI_FONTRESET,		"Font reset",	MT_FONTRESET, 0,	     M_YESNO) \
+X(MI_FONTEFFECT,	"Font effect",	MT_MENU,      0,	     M_EFFECT)\
+X(MI_BORDER,		"Black border",	MT_FONTEFFECT,FE_BORDER,     M_YESNO) \
+X(MI_SHADOW,		"Shadow",	MT_FONTEFFECT,FE_SHADOW,     M_YESNO) \
+X(MI_TRANSWHITE,	"Trans/white",	MT_FONTEFFECT,FE_TRANSWHITE, M_YESNO) \
+X(MI_BLACKWHITE,	"Black/white",	MT_FONTEFFECT,FE_BLACKWHITE, M_YESNO) \
+X(MI_INVERT,		"Invert",	MT_FONTEFFECT,FE_INVERT,     M_YESNO) \
+X(MI_PLUS,		"+",		MT_STEP,      0,	     NULL)    \
+X(MI_MINUS,		"-",		MT_STEP,      1,	     NULL)    \
+X(MI_YES,		"Yes",		MT_CONFIRM,   true,	     NULL)    \
+X(MI_NO,		"No",		MT_CONFIRM,   false,	     NULL)    \
+
+/* X-macro generating menu ids. Note that enums are 16 bits by default. */
+typedef enum menuitem16_t {
+#define X(key, name, type, data, children) key,
+    MENUITEM_TABLE
+#undef X
+    MENUITEM_COUNT,
+    MI_NONE = MENUITEM_COUNT	/* end of sub-items */
+} menuitem16_t;
+
+typedef uint8_t menuitem_t;	/* use as short enum as possible */
 
 /* X-macros generating menu names. */
-#define X(key, name) \
+#define X(key, name, type, data, children) \
     const char s_ ## key[] PROGMEM = name;
     MENUITEM_TABLE
 #undef X
 const char * const MENU_NAMES[] PROGMEM = {
-#define X(key, name) s_ ## key,
+#define X(key, name, type, data, children) s_ ## key,
     MENUITEM_TABLE
 #undef X
 };
 
-/* X-macro generating menu ids. Note that enums are 16 bits by default. */
-typedef enum menuitem16_t {
-#define X(key, name) key,
-    MENUITEM_TABLE
-#undef X
-    MENUITEM_COUNT
-} menuitem16_t;
+typedef enum element_t {	/* layout elements */
+    EL_SENSOR0,			/* sensor 0 voltage */
+    EL_SENSOR1,			/* sensor 1 voltage */
+    EL_SENSOR2,			/* sensor 2 voltage */
+    EL_SENSOR3,			/* sensor 3 voltage */
+    EL_RUNTIME,			/* runtime */
+    EL_CONSUMPTION,		/* consumed charge */
+    EL_PERCENT0,		/* sensor 0 LiPo percentage */
+    EL_PERCENT1,		/* sensor 1 LiPo percentage */
+    EL_PERCENT2,		/* sensor 2 LiPo percentage */
+    EL_PERCENT3,		/* sensor 3 LiPo percentage */
+    EL_BAR0,			/* sensor 0 LiPo bar graph */
+    EL_BAR1,			/* sensor 1 LiPo bar graph */
+    EL_BAR2,			/* sensor 2 LiPo bar graph */
+    EL_BAR3,			/* sensor 3 LiPo bar graph */
+    EL_COUNT,			/* number of elements */
+} element_t;
+
+typedef struct elementdef_t {		/* layout element config bindings */
+    bool	(*get_v)(void);		/* get element's visibility */
+    bool	(*set_v)(bool);		/* set element's visibility */
+    uint8_t	(*get_pos[2])(void);	/* get element's x/y-position */
+    bool	(*set_pos[2])(uint8_t);	/* set element's x/y-position */
+    const char	*(*get_t)(void);	/* get element's text or NULL */
+} elementdef_t;
+
+/* Config bindings of layout elements, in order of element_t. */
+const elementdef_t ELEMENTS[] PROGMEM = {
+    { cfg_get_sensv0, cfg_set_sensv0,
+      { cfg_get_sensx0, cfg_get_sensy0 }, { cfg_set_sensx0, cfg_set_sensy0 },
+      cfg_get_senst0 },
+    { cfg_get_sensv1, cfg_set_sensv1,
+      { cfg_get_sensx1, cfg_get_sensy1 }, { cfg_set_sensx1, cfg_set_sensy1 },
+      cfg_get_senst1 },
+    { cfg_get_sensv2, cfg_set_sensv2,
+      { cfg_get_sensx2, cfg_get_sensy2 }, { cfg_set_sensx2, cfg_set_sensy2 },
+      cfg_get_senst2 },
+    { cfg_get_sensv3, cfg_set_sensv3,
+      { cfg_get_sensx3, cfg_get_sensy3 }, { cfg_set_sensx3, cfg_set_sensy3 },
+      cfg_get_senst3 },
+    { cfg_get_timev, cfg_set_timev,
+      { cfg_get_timex, cfg_get_timey }, { cfg_set_timex, cfg_set_timey },
+      cfg_get_timet },
+    { cfg_get_mahv, cfg_set_mahv,
+      { cfg_get_mahx, cfg_get_mahy }, { cfg_set_mahx, cfg_set_mahy },
+      cfg_get_maht },
+    { cfg_get_pctv0, cfg_set_pctv0,
+      { cfg_get_pctx0, cfg_get_pcty0 }, { cfg_set_pctx0, cfg_set_pcty0 },
+      NULL },
+    { cfg_get_pctv1, cfg_set_pctv1,
+      { cfg_get_pctx1, cfg_get_pcty1 }, { cfg_set_pctx1, cfg_set_pcty1 },
+      NULL },
+    { cfg_get_pctv2, cfg_set_pctv2,
+      { cfg_get_pctx2, cfg_get_pcty2 }, { cfg_set_pctx2, cfg_set_pcty2 },
+      NULL },
+    { cfg_get_pctv3, cfg_set_pctv3,
+      { cfg_get_pctx3, cfg_get_pcty3 }, { cfg_set_pctx3, cfg_set_pcty3 },
+      NULL },
+    { cfg_get_barv0, cfg_set_barv0,
+      { cfg_get_barx0, cfg_get_bary0 }, { cfg_set_barx0, cfg_set_bary0 },
+      NULL },
+    { cfg_get_barv1, cfg_set_barv1,
+      { cfg_get_barx1, cfg_get_bary1 }, { cfg_set_barx1, cfg_set_bary1 },
+      NULL },
+    { cfg_get_barv2, cfg_set_barv2,
+      { cfg_get_barx2, cfg_get_bary2 }, { cfg_set_barx2, cfg_set_bary2 },
+      NULL },
+    { cfg_get_barv3, cfg_set_barv3,
+      { cfg_get_barx3, cfg_get_bary3 }, { cfg_set_barx3, cfg_set_bary3 },
+      NULL },
+};
 
-typedef uint8_t menuitem_t;	/* use as short enum as possible */
+#define CH_BAR0	(0x09)	/* empty bar cell, next 4 chars fill 1/4 .. 4/4 */
+
+typedef struct span_t {		/* screen area of printed element */
+    uint8_t	x;		/* x-position */
+    uint8_t	y;		/* y-position */
+    uint8_t	len;		/* length, 0 if nothing printed */
+} span_t;
+
+typedef enum screenreg_t {	/* adjustable screen registers */
+    SR_HOS,			/* horizontal offset */
+    SR_VOS,			/* vertical offset */
+    SR_CBL,			/* character black level */
+    SR_CWL,			/* character white level */
+    SR_INSMUX1,			/* sharpness 1 */
+    SR_INSMUX2,			/* sharpness 2 */
+} screenreg_t;
+
+static int8_t menu_cbl(int16_t);
+static int8_t menu_cwl(int16_t);
+
+/* Display values of screen registers, indexed by register value. */
+const uint8_t CBLVALS[] PROGMEM = { 0, 10, 20, 30 };
+const uint8_t CWLVALS[] PROGMEM = { 120, 100, 90, 80 };
+const uint8_t INSMUX1VALS[] PROGMEM = { 20, 30, 35, 60, 80, 110 };
+const uint8_t INSMUX2VALS[] PROGMEM = { 30, 35, 50, 75, 100, 120 };
+
+typedef struct screenregdef_t {		/* screen register bindings */
+    int8_t	(*adjust)(int16_t);	/* adjust by step, return value */
+    int8_t	step;			/* step for "+" */
+    int8_t	offset;			/* offset of displayed value */
+    const uint8_t *vals;		/* displayed values or NULL */
+    uint8_t	nvals;			/* number of displayed values */
+    char	unit[3];		/* unit of displayed value */
+} screenregdef_t;
+
+/* Bindings of screen registers, in order of screenreg_t. */
+const screenregdef_t SCREENREGS[] PROGMEM = {
+    { max_hos,	   1, -32, NULL,	0,			  ""   },
+    { max_vos,	   1, -16, NULL,	0,			  ""   },
+    { menu_cbl,	   1,   0, CBLVALS,	sizeof(CBLVALS),	  "%"  },
+    { menu_cwl,	  -1,   0, CWLVALS,	sizeof(CWLVALS),	  "%"  },
+    { max_insmux1, 1,   0, INSMUX1VALS,	sizeof(INSMUX1VALS),	  "ns" },
+    { max_insmux2, 1,   0, INSMUX2VALS,	sizeof(INSMUX2VALS),	  "ns" },
+};
 
-/* Unique 32 bits flag for each menu item. */
-#define FLAG(id) ((uint32_t)1 << (id))
+/* Sub-item lists. */
+const menuitem_t M_ROOT[] PROGMEM = { MI_EMPTY, MI_NONE };
+const menuitem_t M_MAIN[] PROGMEM = {
+    MI_LAYOUT, MI_CALIBRATION, MI_SCREEN, MI_ABOUT, MI_NONE
+};
+const menuitem_t M_LAYOUT[] PROGMEM = {
+    MI_LAYSENSOR0, MI_LAYSENSOR1, MI_LAYSENSOR2, MI_LAYSENSOR3, MI_RUNTIME,
+    MI_CONSUMPTION, MI_PERCENT, MI_BAR, MI_NONE
+};
+const menuitem_t M_PERCENT[] PROGMEM = {
+    MI_PCTSENSOR0, MI_PCTSENSOR1, MI_PCTSENSOR2, MI_PCTSENSOR3, MI_NONE
+};
+const menuitem_t M_BAR[] PROGMEM = {
+    MI_BARSENSOR0, MI_BARSENSOR1, MI_BARSENSOR2, MI_BARSENSOR3, MI_NONE
+};
+const menuitem_t M_SHOW[] PROGMEM = { MI_VISIBLE, MI_INVISIBLE, MI_NONE };
+const menuitem_t M_AXIS[] PROGMEM = { MI_HORIZONTAL, MI_VERTICAL, MI_NONE };
+const menuitem_t M_CALIB[] PROGMEM = {
+    MI_CALSENSOR0, MI_CALSENSOR1, MI_CALSENSOR2, MI_CALSENSOR3, MI_NONE
+};
+const menuitem_t M_SCREEN[] PROGMEM = {
+    MI_ENABLE, MI_HOS, MI_VOS, MI_CBL, MI_CWL, MI_INSMUX1, MI_INSMUX2,
+    MI_FONT, MI_NONE
+};
+const menuitem_t M_FONT[] PROGMEM = { MI_FONTRESET, MI_FONTEFFECT, MI_NONE };
+const menuitem_t M_EFFECT[] PROGMEM = {
+    MI_BORDER, MI_SHADOW, MI_TRANSWHITE, MI_BLACKWHITE, MI_INVERT, MI_NONE
+};
+const menuitem_t M_STEP[] PROGMEM = { MI_PLUS, MI_MINUS, MI_NONE };
+const menuitem_t M_YESNO[] PROGMEM = { MI_YES, MI_NO, MI_NONE };
+
+typedef struct menudef_t {		/* menu item description */
+    uint8_t		type;		/* item type, see menutype_t */
+    uint8_t		data;		/* type specific data */
+    const menuitem_t	*children;	/* sub-items or NULL */
+} menudef_t;
+
+/* X-macro generating menu item descriptions. */
+const menudef_t MENUDEFS[] PROGMEM = {
+#define X(key, name, type, data, children) { type, data, children },
+    MENUITEM_TABLE
+#undef X
+};
 
-typedef struct menu_t {		/* single menu element */
-    menuitem_t 	id;		/* id referring to name in progmem */
-    menu_t 	*children;	/* list of sub-menus if any */
-    menu_t 	*parent;	/* parent menu */
-    uint8_t 	ci;		/* index of current child */
-} menu_t;
+#define MENUDEPTH (7)		/* max. depth of menu path */
 
-typedef struct menus_t {	/* all menus linked together */
-    uint32_t 	act_flags;	/* shortcut to find active menus */
-    menu_t	*active;	/* active menu */
-    menu_t 	*root;		/* root menu */
+typedef struct menus_t {	/* menu state */
+    menuitem_t	path[MENUDEPTH];/* items from root to active item */
+    uint8_t	depth;		/* path length, 0 if menu is idle */
+    uint8_t	ci;		/* index of current sub-item */
     const char 	*msg;		/* message to print in middle of screen */
 } menus_t;
 
@@ -644,6 +879,38 @@ typedef enum adjust_t {		/* adjust element types */
 } adjust_t;
 
 
+/*------------------------------------------------------------------------
+ *  Function	: menu_cbl
+ *  Purpose	: Adjust character black level of all characters.
+ *  Method	: Use Max7456 routine.
+ *
+ *  Returns	: The new value on success, -1 otherwise.
+ *------------------------------------------------------------------------
+ */
+static int8_t
+menu_cbl(
+    int16_t 	step)	/* step to adjust */
+{
+    return max_cbl(-1, step);
+} /* menu_cbl() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: menu_cwl
+ *  Purpose	: Adjust character white level of all characters.
+ *  Method	: Use Max7456 routine.
+ *
+ *  Returns	: The new value on success, -1 otherwise.
+ *------------------------------------------------------------------------
+ */
+static int8_t
+menu_cwl(
+    int16_t 	step)	/* step to adjust */
+{
+    return max_cwl(-1, step);
+} /* menu_cwl() */
+
+
 /*------------------------------------------------------------------------
  *  Function	: menu_get_name
  *  Purpose	: Get menu element name from progmem.
@@ -666,102 +933,173 @@ menu_get_name(
 
 
 /*------------------------------------------------------------------------
- *  Function	: menus_init
- *  Purpose	: Initialise menus.
- *  Method	: Define static menus and link them together.
+ *  Function	: menu_type
+ *  Purpose	: Get menu item type from progmem.
+ *  Method	: Use progmem routines.
+ *
+ *  Returns	: The type, MT_MENU for MI_NONE (the root).
+ *------------------------------------------------------------------------
+ */
+static uint8_t
+menu_type(
+    menuitem_t 	id)		/* menu item */
+{
+    if (id == MI_NONE) return MT_MENU;
+    return pgm_read_byte(&MENUDEFS[id].type);
+} /* menu_type() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: menu_data
+ *  Purpose	: Get menu item's type specific data from progmem.
+ *  Method	: Use progmem routines.
+ *
+ *  Returns	: The data.
+ *------------------------------------------------------------------------
+ */
+static uint8_t
+menu_data(
+    menuitem_t 	id)		/* menu item */
+{
+    return pgm_read_byte(&MENUDEFS[id].data);
+} /* menu_data() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: menu_children
+ *  Purpose	: Get sub-items of active menu item.
+ *  Method	: Use progmem routines.
+ *
+ *  Returns	: Pointer to progmem list ending with MI_NONE, NULL if the
+ *  		  active item is a leaf.
+ *------------------------------------------------------------------------
+ */
+static const menuitem_t *
+menu_children(
+    const menus_t	*menus)	/* menu state */
+{
+    if (menus->depth == 0) return M_ROOT;
+    return (const menuitem_t *)
+	pgm_read_word(&MENUDEFS[menus->path[menus->depth - 1]].children);
+} /* menu_children() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: menu_item
+ *  Purpose	: Get item from active path.
+ *  Method	: Index path from the active item upwards.
+ *
+ *  Returns	: The item, MI_NONE if above root.
+ *------------------------------------------------------------------------
+ */
+static menuitem_t
+menu_item(
+    const menus_t	*menus,	/* menu state */
+    uint8_t		up)	/* 0 for active item, 1 for its parent etc. */
+{
+    if (up >= menus->depth) return MI_NONE;
+    return menus->path[menus->depth - 1 - up];
+} /* menu_item() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: menu_enter
+ *  Purpose	: Make current sub-item the active item.
+ *  Method	: Push sub-item on path, select its initial sub-item.
+ *
+ *  The initial sub-item is "No" for font actions, "Invisible" for hidden
+ *  elements and the first sub-item otherwise.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+menu_enter(
+    menus_t	*menus)	/* menu state */
+{
+    menuitem_t	id;	/* item to enter */
+
+    id = pgm_read_byte(&menu_children(menus)[menus->ci]);
+    if (id == MI_NONE || menus->depth >= MENUDEPTH) return;
+    menus->path[menus->depth++] = id;
+    menus->ci = 0;
+    switch (menu_type(id)) {
+    case MT_ELEMENT:
+	if (!((bool (*)(void))
+	      pgm_read_word(&ELEMENTS[menu_data(id)].get_v))()) {
+	    menus->ci = 1;
+	}
+	break;
+    case MT_FONTRESET:
+    case MT_FONTEFFECT:
+	menus->ci = 1;
+	break;
+    }
+} /* menu_enter() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: menu_leave
+ *  Purpose	: Make parent of active item the active item.
+ *  Method	: Pop item from path, select it as current sub-item.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+menu_leave(
+    menus_t	*menus)	/* menu state */
+{
+    menuitem_t		id;		/* item to leave */
+    const menuitem_t	*children;	/* sub-items of parent */
+
+    if (menus->depth == 0) return;
+    id = menus->path[--menus->depth];
+    children = menu_children(menus);
+    for (menus->ci = 0; pgm_read_byte(&children[menus->ci]) != id;
+	 menus->ci++);
+} /* menu_leave() */
+
+
+
+/*------------------------------------------------------------------------
+ *  Function	: print_span
+ *  Purpose	: Print string at position, erasing the previous one.
+ *  Method	: Erase cells of previous span that won't be overwritten,
+ *  		  print string and remember its span.
  *
- *  Returns	: Pointer to root menu.
+ *  Printing uses compare-before-set, so cells that didn't change are not
+ *  written to the Max7456 again.
+ *
+ *  Returns	: Nothing.
  *------------------------------------------------------------------------
  */
-static menus_t *
-menus_init(void)
+static void
+print_span(
+	span_t		*span,	/* span printed before */
+	uint8_t		x,	/* x-position */
+	uint8_t		y,	/* y-position */
+	const char	*str)	/* string to print, NULL to erase only */
 {
-    static menu_t yesno[] = {
-	{ MI_YES,	NULL, NULL, 0 },
-	{ MI_NO, 	NULL, NULL, 0 },
-	{ MI_NONE }
-    };
-    static menu_t plusminus[] = {
-	{ MI_PLUS, 	NULL, NULL, 0 },
-	{ MI_MINUS, 	NULL, NULL, 0 },
-	{ MI_NONE }
-    };
-    static menu_t position[] = {
-	{ MI_HORIZONTAL,&plusminus[0], 	NULL, 0 },
-	{ MI_VERTICAL, 	&plusminus[0], 	NULL, 0 },
-	{ MI_NONE }
-    };
-    static menu_t showelement[] = {
-	{ MI_VISIBLE, 	&position[0], 	NULL, 0 },
-	{ MI_INVISIBLE, NULL, 		NULL, 0 },
-	{ MI_NONE }
-    };
-
-    /* Use actual elements' visibility as starting point. */
-    static menu_t layout[] = {
-	{ MI_SENSOR0, &showelement[0], 	NULL,
-	    cfg_get_sensv0() ? (uint8_t)0 : (uint8_t)1 },
-	{ MI_SENSOR1, &showelement[0], 	NULL,
-	    cfg_get_sensv1() ? (uint8_t)0 : (uint8_t)1 },
-	{ MI_SENSOR2, &showelement[0], 	NULL,
-	    cfg_get_sensv2() ? (uint8_t)0 : (uint8_t)1 },
-	{ MI_SENSOR3, &showelement[0], 	NULL,
-	    cfg_get_sensv3() ? (uint8_t)0 : (uint8_t)1 },
-	{ MI_RUNTIME, &showelement[0], 	NULL,
-	    cfg_get_timev() ? (uint8_t)0 : (uint8_t)1 },
-	{ MI_NONE }
-    };
-    static menu_t calibration[] = {
-	{ MI_SENSOR0, 	&plusminus[0], 	NULL, 0 },
-	{ MI_SENSOR1, 	&plusminus[0], 	NULL, 0 },
-	{ MI_SENSOR2, 	&plusminus[0], 	NULL, 0 },
-	{ MI_SENSOR3, 	&plusminus[0], 	NULL, 0 },
-	{ MI_NONE }
-    };
-    static menu_t fonteffect[] = {
-	{ MI_BORDER,	&yesno[0], 	NULL, 1 },
-	{ MI_SHADOW,	&yesno[0], 	NULL, 1 },
-	{ MI_TRANSWHITE,&yesno[0], 	NULL, 1 },
-	{ MI_BLACKWHITE,&yesno[0], 	NULL, 1 },
-	{ MI_INVERT,	&yesno[0], 	NULL, 1 },
-	{ MI_NONE }
-    };
-    static menu_t font[] = {
-	{ MI_FONTRESET,	&yesno[0], 	NULL, 1 },
-	{ MI_FONTEFFECT,&fonteffect[0],	NULL, 0 },
-	{ MI_NONE }
-    };
-    static menu_t screen[] = {
-	{ MI_ENABLE, 	&yesno[0], 	NULL, 0 },
-	{ MI_HOS, 	&plusminus[0], 	NULL, 0 },
-	{ MI_VOS, 	&plusminus[0], 	NULL, 0 },
-	{ MI_CBL, 	&plusminus[0], 	NULL, 0 },
-	{ MI_CWL, 	&plusminus[0], 	NULL, 0 },
-	{ MI_INSMUX1, 	&plusminus[0], 	NULL, 0 },
-	{ MI_INSMUX2, 	&plusminus[0], 	NULL, 0 },
-	{ MI_FONT,	&font[0], 	NULL, 0 },
-	{ MI_NONE }
-    };
-    static menu_t mainmenu[] = {
-	{ MI_LAYOUT, 		&layout[0], 	NULL, 0 },
-	{ MI_CALIBRATION,	&calibration[0],NULL, 0 },
-	{ MI_SCREEN, 		&screen[0], 	NULL, 0 },
-	{ MI_ABOUT, 		NULL, 		NULL, 0 },
-	{ MI_NONE }
-    };
-    static menu_t nomenu[] = {
-	{ MI_EMPTY, 	&mainmenu[0], 	NULL, 0 },
-	{ MI_NONE }
-    };
-    static menu_t root = { MI_NONE, &nomenu[0], NULL, 0 };
-    static menus_t menus = {
-	0,
-	&root,
-	&root,
-	NULL
-    };
-    return &menus;
-} /* menus_init() */
+    int32_t 	pos[2];				/* position to print */
+    uint8_t 	len = str == NULL ? 0 : strlen(str);	/* string length */
+    uint8_t 	c;				/* x-position of cell */
+
+    pos[1] = span->y;
+    for (c = span->x; c < span->x + span->len; c++) {
+	if (span->y == y && c >= x && c < x + len) continue;
+	pos[0] = c;
+	cmd_p_raw(pos, 0, 1, "");	/* 0x00 acts as empty value */
+    }
+    if (len > 0) {
+	pos[0] = x;
+	pos[1] = y;
+	cmd_p_raw(pos, 0, len, str);
+    }
+    span->x = x;
+    span->y = y;
+    span->len = len;
+} /* print_span() */
 
 
 /*------------------------------------------------------------------------
@@ -769,211 +1107,202 @@ menus_init(void)
  *  Purpose	: Print sensor voltages and runtime on screen.
  *  Method	: Convert data to string format and print.
  *
- *  Parameter values is a static array that we re-use here to save precious
- *  heap memory.
+ *  Sensor voltages are averaged in millivolts using integer math; there's no
+ *  need for floating point here. Each element only rewrites the characters
+ *  that changed and erases what is left of its previous span, so there is
+ *  no need to clear the screen while manipulating elements.
+ *
+ *  Percentage and bar graph elements show the LiPo state of charge. Like
+ *  examples/battery.php, the number of cells is derived from the first
+ *  voltage measured, so the battery should be charged at power up.
  *
  *  Returns	: Nothing.
  *------------------------------------------------------------------------
  */
 static void
 print_elements(
-	uint32_t 	act_flags,	/* indication of selected menus */
+	bool		editing,	/* whether menu is in use */
         unsigned long 	thistime,	/* current timestamp */
-	const char 	*msg,		/* string to print in screen center */
-	float 		*values)	/* sensor values */
+	const char 	*msg)		/* string to print in screen center */
 {
 #define AVGC 10
+#define MAXCELLMV 4500
     static uint8_t 	ac;			/* average counter */
-    int32_t 		pos[2] = { 0, 0 };	/* position to print */
-    char 		buf[6];			/* print buffer */
+    static int32_t 	sums[SENSOR_COUNT];	/* sums of sensor values (mV) */
+    static uint8_t 	cells[SENSOR_COUNT];	/* LiPo cells, 0 if unknown */
+    static span_t	spans[EL_COUNT + 1];	/* elements and message printed */
+    int32_t 		mvs[SENSOR_COUNT];	/* sensor values (mV) */
+    char 		buf[16];		/* print buffer */
+    const elementdef_t	*el;			/* element bindings */
+    const char *	(*get_t)(void);		/* get element's text */
+    uint8_t 		element;		/* element index */
     uint8_t 		sensor;			/* sensor index */
     uint8_t 		hours;			/* part of runtime */
     uint8_t 		minutes;		/* part of runtime */
     uint16_t 		seconds;		/* part of runtime */
-    int 		num;			/* number of bytes printed */
-    int 		len;			/* string length */
-    const char		*str;			/* string */
-    bool 		(*get_v)(void);		/* get element's visibility */
-    uint8_t 		(*get_x)(void);		/* get element's x-position */
-    uint8_t 		(*get_y)(void);		/* get element's y-position */
-    const char *	(*get_t)(void);		/* get element's text */
-    float 		sensor_value;		/* sensor voltage value */
+    uint8_t 		len;			/* string length */
+    uint8_t 		fill;			/* bar fill in quarter cells */
+    int32_t 		value;			/* charge (mAh) or percentage */
 
-    /* Clear whole screen while manipulating elements. */
-    if (act_flags != 0) {
-	cmd_clear(NULL);
+    if (editing) {
 
 	/* Make sure counting starts at zero when averaging. */
 	ac = 0;
-
-	if (act_flags & FLAG(MI_ABOUT)) {
-            msg = cfg_get_version();
-	}
     } else {
 
 	/* Count number of values before calculating average value. */
 	ac = (ac + 1) % AVGC;
     }
 
-    /* Print sensor voltages. */
+    /* Negative voltage means busy averaging, don't print yet. */
     for (sensor = SENSOR0; sensor < SENSOR_COUNT; sensor++) {
-	switch (sensor) {
-	case SENSOR0 :
-	    get_v = cfg_get_sensv0;
-	    get_x = cfg_get_sensx0;
-	    get_y = cfg_get_sensy0;
-	    get_t = cfg_get_senst0;
-	    break;
-	case SENSOR1 :
-	    get_v = cfg_get_sensv1;
-	    get_x = cfg_get_sensx1;
-	    get_y = cfg_get_sensy1;
-	    get_t = cfg_get_senst1;
+	if (editing) {
+	    sums[sensor] = 0;
+	    mvs[sensor] = sensor_get_mv((sensor_t)sensor);
+	} else {
+	    sums[sensor] += sensor_get_mv((sensor_t)sensor);
+	    if (ac == 0) {
+		mvs[sensor] = (sums[sensor] + AVGC / 2) / AVGC;
+		sums[sensor] = 0;
+	    } else {
+		mvs[sensor] = -1;
+	    }
+	}
+	if (cells[sensor] == 0 && mvs[sensor] > 0) {
+	    cells[sensor] = 1 + mvs[sensor] / MAXCELLMV;
+	}
+    }
+
+    for (element = EL_SENSOR0; element < EL_COUNT; element++) {
+	el = &ELEMENTS[element];
+	if (!((bool (*)(void))pgm_read_word(&el->get_v))()) {
+	    print_span(&spans[element], 0, 0, NULL);
+	    continue;
+	}
+	switch (element) {
+	case EL_RUNTIME:
+	    seconds = thistime / 1000;
+	    minutes = seconds / 60;
+	    hours = minutes / 60;
+	    minutes = minutes % 60;
+	    seconds = seconds % 60;
+	    utoa(hours, buf, 10);
+	    len = strlen(buf);
+	    buf[len++] = ':';
+	    buf[len++] = '0' + minutes / 10;
+	    buf[len++] = '0' + minutes % 10;
+	    buf[len++] = ':';
+	    buf[len++] = '0' + seconds / 10;
+	    buf[len++] = '0' + seconds % 10;
+	    buf[len] = '\0';
 	    break;
-	case SENSOR2 :
-	    get_v = cfg_get_sensv2;
-	    get_x = cfg_get_sensx2;
-	    get_y = cfg_get_sensy2;
-	    get_t = cfg_get_senst2;
+	case EL_CONSUMPTION:
+
+	    /* Print remaining charge if capacity is known. */
+	    if ((value = sensor_get_mah(true)) < 0) {
+		value = sensor_get_mah(false);
+	    }
+	    if (value > 99999) value = 99999;
+	    ltoa(value, buf, 10);
 	    break;
-	case SENSOR3 :
-	    get_v = cfg_get_sensv3;
-	    get_x = cfg_get_sensx3;
-	    get_y = cfg_get_sensy3;
-	    get_t = cfg_get_senst3;
+	case EL_PERCENT0:
+	case EL_PERCENT1:
+	case EL_PERCENT2:
+	case EL_PERCENT3:
+	    sensor = element - EL_PERCENT0;
+	    if (mvs[sensor] <= 0) continue;
+	    value = sensor_lipo_percent(mvs[sensor] / cells[sensor]);
+	    utoa(value, buf, 10);
+	    strcat(buf, "%");
 	    break;
-	}
-	if (get_v()) {
-            if (act_flags != 0) {
-		sensor_value = sensor_get_value((sensor_t)sensor);
-	    } else {
-		values[sensor] +=
-		    sensor_get_value((sensor_t)sensor) / (float)AVGC;
-		if (ac == 0) {
-		    sensor_value = values[sensor];
-		    values[sensor] = 0;
-		} else {
-		    sensor_value = -1;
-		}
+	case EL_BAR0:
+	case EL_BAR1:
+	case EL_BAR2:
+	case EL_BAR3:
+	    sensor = element - EL_BAR0;
+	    if (mvs[sensor] <= 0) continue;
+	    value = sensor_lipo_percent(mvs[sensor] / cells[sensor]);
+	    if ((len = cfg_get_barlen()) > sizeof(buf) - 1) {
+		len = sizeof(buf) - 1;
 	    }
-
-	    /* Negative voltage means busy averaging, don't print yet. */
-	    if (sensor_value > 0) {
-		pos[0] = get_x();
-		pos[1] = get_y();
-		dtostrf(sensor_value, sizeof(buf) - 1, 2, buf);
-		len = strlen(buf);
-		cmd_p_raw(pos, 0, len, buf);
-		num = len;
-		str = get_t();
-		len = strlen(str);
-		if (len > 0) cmd_p_raw(pos, num, len, str);
+	    fill = (value * len * 4 + 50) / 100;
+	    for (uint8_t i = 0; i < len; i++, fill -= fill < 4 ? fill : 4) {
+		buf[i] = CH_BAR0 + (fill < 4 ? fill : 4);
 	    }
+	    buf[len] = '\0';
+	    break;
+	default:
+	    sensor = element - EL_SENSOR0;
+	    if (mvs[sensor] <= 0) continue;
+	    fixtostrf((mvs[sensor] + 5) / 10, 5, 2, buf);
+	    break;
 	}
+	get_t = (const char *(*)(void))pgm_read_word(&el->get_t);
+	if (get_t != NULL) strlcat(buf, get_t(), sizeof(buf));
+	print_span(&spans[element],
+		   ((uint8_t (*)(void))pgm_read_word(&el->get_pos[0]))(),
+		   ((uint8_t (*)(void))pgm_read_word(&el->get_pos[1]))(), buf);
     }
 
-    /* Print run time. */
-    if (!cfg_get_timev()) return;
-    pos[0] = cfg_get_timex();
-    pos[1] = cfg_get_timey();
-    seconds = thistime / 1000;
-    minutes = seconds / 60;
-    hours = minutes / 60;
-    minutes = minutes % 60;
-    seconds = seconds % 60;
-    utoa(hours, buf, 10);
-    len = strlen(buf);
-    num = 0;
-    cmd_p_raw(pos, num, len, buf);
-    num += len;
-    buf[0] = ':';
-    if (minutes < 10) {
-	buf[1] = '0';
-	len = 2;
-    } else {
-	len = 1;
-    }
-    utoa(minutes, buf + len, 10);
-    cmd_p_raw(pos, num, 3, buf);
-    num += 3;
-    if (seconds < 10) {
-	buf[1] = '0';
-	len = 2;
-    } else {
-	len = 1;
-    }
-    utoa(seconds, buf + len, 10);
-    cmd_p_raw(pos, num, 3, buf);
-    num += 3;
-    str = cfg_get_timet();
-    len = strlen(str);
-    if (len > 0) cmd_p_raw(pos, num, len, str);
-
     /* Print message. */
-    if (msg != NULL) {
-        len = strlen(msg);
-	pos[0] = 14 - len/2;
-	pos[1] = 6;
-        cmd_p_raw(pos, 0, len, msg);
-    }
+    len = msg == NULL ? 0 : strlen(msg);
+    print_span(&spans[EL_COUNT], 14 - len/2, 6, msg);
+#undef AVGC
+#undef MAXCELLMV
 } /* print_elements() */
 
 
 /*------------------------------------------------------------------------
  *  Function	: print_menu
  *  Purpose	: Print active menu contents and all parent menu names.
- *  Method	: Walk from root menu to active menu, print all child menus
- *  		  and highlight current child.
+ *  Method	: Walk path from root to active item, print all sub-items
+ *  		  of active item and highlight current sub-item.
+ *
+ *  The screen is cleared also when the active item has no sub-items, so the
+ *  elements are printed on an empty screen by print_elements().
  *
  *  Returns	: Nothing.
  *------------------------------------------------------------------------
  */
 static void
 print_menu(
-	menu_t *root,	/* root menu */
-	menu_t *menu)	/* active menu */
+	const menus_t	*menus)	/* menu state */
 {
-#define X 9
-#define Y 5
-    int32_t 	pos[2] = { X, Y };	/* position to print */
-    const char 	*str;			/* string to print */
-    int 	len;			/* string length */
-    int 	maxlen = 0;		/* max string length */
-    int 	num;			/* number of bytes printed */
-    int 	i;			/* loop couinter */
-    menu_t 	*m;			/* current menu, starting at root */
-
-    if (menu->children == NULL) return;
+    int32_t 		pos[2] = { 1, 1 };	/* position to print */
+    const char 		*str;			/* string to print */
+    int 		len;			/* string length */
+    int 		maxlen = 0;		/* max string length */
+    int 		num;			/* number of bytes printed */
+    uint8_t 		i;			/* loop counter */
+    const menuitem_t	*children;		/* sub-items of active item */
+    menuitem_t		id;			/* sub-item */
+
     cmd_clear(NULL);
-    pos[0] = 1;
-    pos[1] = 1;
-    m = root;
-    while (m != menu) {
-	str = menu_get_name(m->children[m->ci].id);
+    if ((children = menu_children(menus)) == NULL) return;
+    for (i = 0; i < menus->depth; i++) {
+	str = menu_get_name(menus->path[i]);
 	len = strlen(str);
 	cmd_p_raw(pos, 0, len, str);
-	m = &m->children[m->ci];
 	pos[0] += 2;
 	pos[1]++;
     }
 
     pos[0] -= 2;
-    for (i = 0; menu->children[i].id != MI_NONE; i++) {
-	str = menu_get_name(menu->children[i].id);
-	len = strlen(str);
+    for (i = 0; (id = pgm_read_byte(&children[i])) != MI_NONE; i++) {
+	len = strlen(menu_get_name(id));
 	if (len > maxlen) maxlen = len;
     }
-    for (i = 0; menu->children[i].id != MI_NONE; i++) {
+    for (i = 0; (id = pgm_read_byte(&children[i])) != MI_NONE; i++) {
 	num = 0;
-	str = menu_get_name(menu->children[i].id);
+	str = menu_get_name(id);
 	len = strlen(str);
-	if (i == menu->ci && *str != '\0') {
+	if (i == menus->ci && *str != '\0') {
 	    cmd_p_raw(pos, num, 3, ">> ");
 	}
 	num += 3;
 	cmd_p_raw(pos, num, len, str);
 	num += len;
-	if (i == menu->ci && *str != '\0') {
+	if (i == menus->ci && *str != '\0') {
 	    while (len < maxlen) {
 	        cmd_p_raw(pos, num, 1, " ");
 		num++;
@@ -984,15 +1313,16 @@ print_menu(
 	num += 3;
 	pos[1]++;
     }
-#undef X
-#undef Y
 } /* print_menu() */
 
 
 /*------------------------------------------------------------------------
  *  Function	: adjust_element
  *  Purpose	: Adjust screen / element based on selected menus.
- *  Method	: Determine selected element and change it if needed.
+ *  Method	: Interpret type of active item and its parents.
+ *
+ *  The active item determines the action, its parents the bound element,
+ *  sensor or register. Confirmations ("Yes"/"No") only act when entered.
  *
  *  Returns	: Nothing.
  *------------------------------------------------------------------------
@@ -1000,80 +1330,34 @@ print_menu(
 static void
 adjust_element(
 	adjust_t	adjust,		/* adjust type */
-	uint32_t 	act_flags,	/* indication of selected menus */
-	const char 	**msg,		/* message */
-	float 		*values,	/* sensor values */
+	menus_t		*menus,		/* menu state */
+	int32_t 	*mvs,		/* sensor values (mV) */
 	bool		*inv_enable)	/* whether to inverse enable on save */
 {
-    bool 	(*get_v)(void);		/* get element's visibility */
-    uint8_t 	(*get_x)(void);		/* get element's x-position */
-    uint8_t 	(*get_y)(void);		/* get element's y-position */
-    bool 	(*set_v)(bool);		/* set element's visibility */
-    bool 	(*set_x)(uint8_t);	/* set element's x-position */
-    bool 	(*set_y)(uint8_t);	/* set element's y-position */
-    sensor_t	sensor = SENSOR_NONE;	/* sensor element */
-    static char	buf[6];			/* message buffer */
-    int8_t 	val;			/* small integer value */
-    const char 	*str;			/* static string */
-    bool 	menu_change = false;
-    bool 	bigsteps = false;
-
-    if (act_flags & FLAG(MI_SENSOR0)) {
-	get_v = cfg_get_sensv0;
-	get_x = cfg_get_sensx0;
-	get_y = cfg_get_sensy0;
-	set_v = cfg_set_sensv0;
-	set_x = cfg_set_sensx0;
-	set_y = cfg_set_sensy0;
-	sensor = SENSOR0;
-    } else if (act_flags & FLAG(MI_SENSOR1)) {
-	get_v = cfg_get_sensv1;
-	get_x = cfg_get_sensx1;
-	get_y = cfg_get_sensy1;
-	set_v = cfg_set_sensv1;
-	set_x = cfg_set_sensx1;
-	set_y = cfg_set_sensy1;
-	sensor = SENSOR1;
-    } else if (act_flags & FLAG(MI_SENSOR2)) {
-	get_v = cfg_get_sensv2;
-	get_x = cfg_get_sensx2;
-	get_y = cfg_get_sensy2;
-	set_v = cfg_set_sensv2;
-	set_x = cfg_set_sensx2;
-	set_y = cfg_set_sensy2;
-	sensor = SENSOR2;
-    } else if (act_flags & FLAG(MI_SENSOR3)) {
-	get_v = cfg_get_sensv3;
-	get_x = cfg_get_sensx3;
-	get_y = cfg_get_sensy3;
-	set_v = cfg_set_sensv3;
-	set_x = cfg_set_sensx3;
-	set_y = cfg_set_sensy3;
-	sensor = SENSOR3;
-    } else if (act_flags & FLAG(MI_RUNTIME)) {
-	get_v = cfg_get_timev;
-	get_x = cfg_get_timex;
-	get_y = cfg_get_timey;
-	set_v = cfg_set_timev;
-	set_x = cfg_set_timex;
-	set_y = cfg_set_timey;
-    } else {
-	get_v = NULL;
-	get_x = NULL;
-	get_y = NULL;
-	set_v = NULL;
-	set_x = NULL;
-	set_y = NULL;
-    }
+    static char		buf[7];		/* message buffer */
+    menuitem_t		id;		/* active item */
+    menuitem_t		parent;		/* parent of active item */
+    const elementdef_t	*el;		/* bound element */
+    const screenregdef_t *reg;		/* bound screen register */
+    uint8_t		axis;		/* element axis */
+    uint8_t		size;		/* screen size along axis */
+    uint8_t		val;		/* small value */
+    int8_t		step;		/* step direction */
+    int32_t		fonteffect;	/* font effect */
+    sensor_t		sensor;		/* bound sensor */
+    bool 		menu_change = false;
+    bool 		bigsteps = false;
+
+    id = menu_item(menus, 0);
+    parent = menu_item(menus, 1);
 
     switch (adjust) {
     case ADJ_CALIBRATION:
-        if ((act_flags & FLAG(MI_PLUS)) != (act_flags & FLAG(MI_MINUS))
-	    && act_flags & FLAG(MI_CALIBRATION)
-	    && sensor != SENSOR_NONE) {
-	    sensor_set_value(sensor, values[sensor]);
-	    dtostrf(values[sensor], sizeof(buf) - 1, 2, buf);
-	    *msg = buf;
+	if (menu_type(id) == MT_STEP && menu_type(parent) == MT_CALIBRATE) {
+	    sensor = (sensor_t)menu_data(parent);
+	    sensor_set_value(sensor, mvs[sensor] / 1000.0);
+	    menus->msg = fixtostrf((mvs[sensor] + 5) / 10, sizeof(buf) - 1, 2,
+				   buf);
 	}
 	break;
     case ADJ_MENUCHANGE:
@@ -1083,21 +1367,24 @@ adjust_element(
 	bigsteps = true;
 	/* FALLTHROUGH */
     case ADJ_SMALLSTEPS:
-        *msg = NULL;
-        if ((act_flags & FLAG(MI_PLUS)) == (act_flags & FLAG(MI_MINUS))) {
-	    if (act_flags & FLAG(MI_LAYOUT)
-		&& set_v != NULL) {
-		if (act_flags & FLAG(MI_VISIBLE)) {
-		    set_v(true);
-		} else if (act_flags & FLAG(MI_INVISIBLE)) {
-		    set_v(false);
-		}
-	    }
-	    if (act_flags & FLAG(MI_ENABLE)) {
-		if (act_flags & FLAG(MI_YES)) {
-		    cfg_set_enable(true);
-		} else if (act_flags & FLAG(MI_NO)) {
-		    cfg_set_enable(false);
+	menus->msg = NULL;
+	switch (menu_type(id)) {
+	case MT_SHOW:
+	    el = &ELEMENTS[menu_data(parent)];
+	    ((bool (*)(bool))pgm_read_word(&el->set_v))(menu_data(id));
+	    break;
+	case MT_ENABLE:
+	    *inv_enable = false;
+	    break;
+	case MT_ABOUT:
+	    menus->msg = cfg_get_version();
+	    break;
+	case MT_CONFIRM:
+	    if (!menu_change) break;
+	    switch (menu_type(parent)) {
+	    case MT_ENABLE:
+		cfg_set_enable(menu_data(id));
+		if (!menu_data(id)) {
 
 		    /*
 		     * Save settings in advance. They will also be saved when
@@ -1109,193 +1396,58 @@ adjust_element(
 		    cfg_save(false);
 		}
 		*inv_enable = false;
-	    }
-	    if (act_flags & FLAG(MI_YES)) {
-	        if (act_flags & FLAG(MI_FONTRESET)) {
-		    cmd_font_reset(NULL);
-		}
-	        if (act_flags & FLAG(MI_FONTEFFECT)) {
-		    int32_t fonteffect = FE_NONE;
-
-	            if (act_flags & FLAG(MI_BORDER)) {
-			fonteffect = FE_BORDER;
-		    } else if (act_flags & FLAG(MI_SHADOW)) {
-			fonteffect = FE_SHADOW;
-		    } else if (act_flags & FLAG(MI_TRANSWHITE)) {
-			fonteffect = FE_TRANSWHITE;
-		    } else if (act_flags & FLAG(MI_BLACKWHITE)) {
-			fonteffect = FE_BLACKWHITE;
-		    } else if (act_flags & FLAG(MI_INVERT)) {
-			fonteffect = FE_INVERT;
-		    }
+		break;
+	    case MT_FONTRESET:
+		if (menu_data(id)) cmd_font_reset(NULL);
+		break;
+	    case MT_FONTEFFECT:
+		if (menu_data(id)) {
+		    fonteffect = menu_data(parent);
 		    cmd_font_effect(&fonteffect);
 		}
+		break;
 	    }
 	    break;
-	}
-	/* (act_flags & FLAG(MI_PLUS)) != (act_flags & FLAG(MI_MINUS)) */
-	if (act_flags & FLAG(MI_LAYOUT)
-	    && get_v != NULL
-	    && get_v()
-	    && !menu_change
-	    && act_flags & FLAG(MI_VISIBLE)) {
-	    if (act_flags & FLAG(MI_HORIZONTAL)) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    set_x(get_x() + 1);
-		    if (get_x() >= screenbuf.cols) {
-			set_x(0);
-		    }
-		} else {
-		    set_x(get_x() - 1);
-		    if ((int8_t)get_x() < 0) {
-			set_x(screenbuf.cols - 1);
-		    }
-		}
-	    }
-	    if (act_flags & FLAG(MI_VERTICAL)) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    set_y(get_y() + 1);
-		    if (get_y() >= screenbuf.rows) {
-			set_y(0);
-		    }
-		} else {
-		    set_y(get_y() - 1);
-		    if ((int8_t)get_y() < 0) {
-			set_y(screenbuf.rows - 1);
-		    }
-		}
-	    }
-	}
-	if (act_flags & FLAG(MI_CALIBRATION)
-	    && sensor != SENSOR_NONE) {
-	    if (!menu_change) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    values[sensor] += (bigsteps ? 0.1 : 0.01);
-		} else {
-		    values[sensor] -= (bigsteps ? 0.1 : 0.01);
-		}
-	    }
-	    dtostrf(values[sensor], sizeof(buf) - 1, 2, buf);
-	    *msg = buf;
-	}
-	if (act_flags & FLAG(MI_HOS)) {
-	    if (!menu_change) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    val = max_hos(1);
-		} else {
-		    val = max_hos(-1);
-		}
-	    } else {
-		val = max_hos(0);
-	    }
-	    if (val < 0) return;
-	    val -= 32;
-	    itoa(val, buf, 10);
-	    *msg = buf;
-	}
-	if (act_flags & FLAG(MI_VOS)) {
-	    if (!menu_change) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    val = max_vos(1);
+	case MT_STEP:
+	    step = menu_data(id) == 0 ? 1 : -1;
+	    switch (menu_type(parent)) {
+	    case MT_AXIS:
+		if (menu_change) break;
+
+		/* path: element -> visible -> axis -> step */
+		el = &ELEMENTS[menu_data(menu_item(menus, 3))];
+		axis = menu_data(parent);
+		size = axis == 0 ? screenbuf.cols : screenbuf.rows;
+		val = ((uint8_t (*)(void))pgm_read_word(&el->get_pos[axis]))();
+		val = (val + size + step) % size;
+		((bool (*)(uint8_t))pgm_read_word(&el->set_pos[axis]))(val);
+		break;
+	    case MT_CALIBRATE:
+		sensor = (sensor_t)menu_data(parent);
+		if (!menu_change) mvs[sensor] += step * (bigsteps ? 100 : 10);
+		menus->msg = fixtostrf((mvs[sensor] + 5) / 10, sizeof(buf) - 1,
+				       2, buf);
+		break;
+	    case MT_REGISTER:
+		reg = &SCREENREGS[menu_data(parent)];
+		val = ((int8_t (*)(int16_t))pgm_read_word(&reg->adjust))(
+		    menu_change ? 0 : step * (int8_t)pgm_read_byte(&reg->step));
+		if ((int8_t)val < 0) return;
+		if (pgm_read_word(&reg->vals) == 0) {
+		    itoa((int8_t)val + (int8_t)pgm_read_byte(&reg->offset), buf,
+			 10);
+		} else if (val < pgm_read_byte(&reg->nvals)) {
+		    utoa(pgm_read_byte((const uint8_t *)
+				       pgm_read_word(&reg->vals) + val), buf, 10);
 		} else {
-		    val = max_vos(-1);
+		    strcpy(buf, "??");
 		}
-	    } else {
-		val = max_vos(0);
+		strlcat_P(buf, reg->unit, sizeof(buf));
+		menus->msg = buf;
+		break;
 	    }
-	    if (val < 0) return;
-	    val -= 16;
-	    itoa(val, buf, 10);
-	    *msg = buf;
-	}
-	if (act_flags & FLAG(MI_CBL)) {
-	    if (!menu_change) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    val = max_cbl(-1, 1);
-		} else {
-		    val = max_cbl(-1, -1);
-		}
-	    } else {
-	        val = max_cbl(-1, 0);
-	    }
-	    if (val < 0) return;
-	    switch (val) {
-	    case 0: str = "0%"; break;
-	    case 1: str = "10%"; break;
-	    case 2: str = "20%"; break;
-	    case 3: str = "30%"; break;
-	    default: str = "??%";
-	    }
-	    strcpy(buf, str);
-	    *msg = buf;
-	}
-	if (act_flags & FLAG(MI_CWL)) {
-	    if (!menu_change) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    val = max_cwl(-1, -1);
-		} else {
-		    val = max_cwl(-1, 1);
-		}
-	    } else {
-	        val = max_cwl(-1, 0);
-	    }
-	    if (val < 0) return;
-	    switch (val) {
-	    case 0: str = "120%"; break;
-	    case 1: str = "100%"; break;
-	    case 2: str = "90%"; break;
-	    case 3: str = "80%"; break;
-	    default: str = "??%";
-	    }
-	    strcpy(buf, str);
-	    *msg = buf;
-	}
-	if (act_flags & FLAG(MI_INSMUX1)) {
-	    if (!menu_change) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    val = max_insmux1(1);
-		} else {
-		    val = max_insmux1(-1);
-		}
-	    } else {
-		val = max_insmux1(0);
-	    }
-	    if (val < 0) return;
-	    switch (val) {
-	    case 0: str = "20ns"; break;
-	    case 1: str = "30ns"; break;
-	    case 2: str = "35ns"; break;
-	    case 3: str = "60ns"; break;
-	    case 4: str = "80ns"; break;
-	    case 5: str = "110ns"; break;
-	    default: str = "??ns";
-	    }
-	    strcpy(buf, str);
-	    *msg = buf;
+	    break;
 	}
-	if (act_flags & FLAG(MI_INSMUX2)) {
-	    if (!menu_change) {
-		if (act_flags & FLAG(MI_PLUS)) {
-		    val = max_insmux2(1);
-		} else {
-		    val = max_insmux2(-1);
-		}
-	    } else {
-		val = max_insmux2(0);
-	    }
-	    if (val < 0) return;
-	    switch (val) {
-	    case 0: str = "30ns"; break;
-	    case 1: str = "35ns"; break;
-	    case 2: str = "50ns"; break;
-	    case 3: str = "75ns"; break;
-	    case 4: str = "100ns"; break;
-	    case 5: str = "120ns"; break;
-	    default: str = "??ns";
-	    }
-	    strcpy(buf, str);
-	    *msg = buf;
- 	}
 	break;
     }
 } /* adjust_element() */
@@ -1311,10 +1463,10 @@ adjust_element(
  */
 static void
 read_sensors(
-	float *values)	/* sensor values */
+	int32_t *mvs)	/* sensor values (mV) */
 {
     for (uint8_t sensor = SENSOR0; sensor < SENSOR_COUNT; sensor++) {
-	values[sensor] = sensor_get_value((sensor_t)sensor);
+	mvs[sensor] = sensor_get_mv((sensor_t)sensor);
     }
 } /* read_sensors() */
 
@@ -1329,11 +1481,11 @@ read_sensors(
  */
 static void
 button_goes_down(
-	menus_t 	*menus,		/* active menu */
+	menus_t 	*menus,		/* menu state */
         unsigned long 	thistime,	/* current timestamp */
         unsigned long 	sensor_change,	/* timestamp last sensor change */
         unsigned long 	*menu_change,	/* timestamp last menu change */
-	float 		*values,	/* sensor values */
+	int32_t 	*mvs,		/* sensor values (mV) */
 	bool		*inv_enable)	/* whether to inverse enable on save */
 {
 } /* button_goes_down() */
@@ -1349,11 +1501,11 @@ button_goes_down(
  */
 static void
 button_is_down(
-	menus_t 	*menus,		/* active menu */
+	menus_t 	*menus,		/* menu state */
         unsigned long 	thistime,	/* current timestamp */
         unsigned long 	sensor_change,	/* timestamp last sensor change */
         unsigned long 	*menu_change,	/* timestamp last menu change */
-	float 		*values,	/* sensor values */
+	int32_t 	*mvs,		/* sensor values (mV) */
 	bool		*inv_enable)	/* whether to inverse enable on save */
 {
 #define LONGPRESSTIME 1000
@@ -1380,24 +1532,21 @@ button_is_down(
     if (span <= LONGPRESSTIME) return;
 
     /* Handle button-hold while the elements are visible. */
-    if (menus->active->children == NULL
+    if (menu_children(menus) == NULL
         && thistime - oldtime > 100) {
         adjust_element(span > LONGLONGPRESSTIME
 		       ? ADJ_BIGSTEPS : ADJ_SMALLSTEPS,
-		       menus->act_flags, &menus->msg, values, inv_enable);
+		       menus, mvs, inv_enable);
 	oldtime = thistime;
 	return;
     }
 
     /* Handle button-hold while the menu is visible. */
-    if (&menus->active->children[menus->active->ci] != NULL) {
-	menus->active->children[menus->active->ci].parent = menus->active;
-	menus->act_flags |= FLAG(menus->active->children[menus->active->ci].id);
-        adjust_element(ADJ_MENUCHANGE, menus->act_flags, &menus->msg, values,
-		       inv_enable);
-	menus->active = &menus->active->children[menus->active->ci];
+    if (menu_children(menus) != NULL) {
+	menu_enter(menus);
+        adjust_element(ADJ_MENUCHANGE, menus, mvs, inv_enable);
 	*menu_change = thistime;
-	print_menu(menus->root, menus->active);
+	print_menu(menus);
     }
 #undef LONGPRESSTIME
 #undef LONGLONGPRESSTIME
@@ -1414,20 +1563,22 @@ button_is_down(
  */
 static void
 button_goes_up(
-	menus_t 	*menus,		/* active menu */
+	menus_t 	*menus,		/* menu state */
         unsigned long 	thistime,	/* current timestamp */
         unsigned long 	sensor_change,	/* timestamp last sensor change */
         unsigned long 	*menu_change,	/* timestamp last menu change */
-	float 		*values,	/* sensor values */
+	int32_t 	*mvs,		/* sensor values (mV) */
 	bool		*inv_enable)	/* whether to inverse enable on save */
 {
+    const menuitem_t	*children;	/* sub-items of active item */
+
     /* Toggle enable|disable while menu is idle. */
-    if (menus->active == menus->root) {
+    if (menus->depth == 0) {
 	cfg_set_enable(!cfg_get_enable());
 	*inv_enable = !*inv_enable;
     }
 
-    if (menus->active->children != NULL) {
+    if ((children = menu_children(menus)) != NULL) {
 
         /*
 	 * Cache sensor values if not yet calibrating.
@@ -1435,38 +1586,33 @@ button_goes_up(
 	 * normal. While calibrating in adjust_element() we use cached values
 	 * while adjusting the voltage up or down. Note that while pressing
 	 * the button, its sensor value is zero so we can't use that.
-	 *
-	 * Don't read sensors if menu is idle. In that case the values are
-	 * used as buffer to calculate average values.
 	 */
-	if (menus->active != menus->root) read_sensors(values);
+	if (menus->depth > 0) read_sensors(mvs);
     } else {
 
         /*
 	 * Adjust calibration of selected sensor if any.
 	 * This uses a cached value to set the sensor at the correct voltage.
 	 */
-        adjust_element(ADJ_CALIBRATION, menus->act_flags, &menus->msg, values,
-		       inv_enable);
+        adjust_element(ADJ_CALIBRATION, menus, mvs, inv_enable);
     }
 
     /* Menu change is handled by button_is_down() already. */
     if (sensor_change < *menu_change) return;
 
     /* Handle short-clicks while the elements are visible. */
-    if (menus->active->children == NULL) {
-        adjust_element(ADJ_SMALLSTEPS, menus->act_flags, &menus->msg, values,
-		       inv_enable);
+    if (children == NULL) {
+        adjust_element(ADJ_SMALLSTEPS, menus, mvs, inv_enable);
         return;
     }
 
     /* Handle short-clicks while the menu is visible. */
-    if (menus->active->children[menus->active->ci + 1].id != MI_NONE) {
-	menus->active->ci++;
+    if (pgm_read_byte(&children[menus->ci + 1]) != MI_NONE) {
+	menus->ci++;
     } else {
-	menus->active->ci = 0;
+	menus->ci = 0;
     }
-    print_menu(menus->root, menus->active);
+    print_menu(menus);
     *menu_change = thistime;
 } /* button_goes_up() */
 
@@ -1481,11 +1627,11 @@ button_goes_up(
  */
 static void
 button_is_up(
-	menus_t 	*menus,		/* active menu */
+	menus_t 	*menus,		/* menu state */
         unsigned long 	thistime,	/* current timestamp */
         unsigned long 	sensor_change,	/* timestamp last sensor change */
         unsigned long 	*menu_change,	/* timestamp last menu change */
-	float 		*values,	/* sensor values */
+	int32_t 	*mvs,		/* sensor values (mV) */
 	bool		*inv_enable)	/* whether to inverse enable on save */
 {
 #define NOPRESSRETURNTIME 2000
@@ -1493,20 +1639,17 @@ button_is_up(
 	? sensor_change : *menu_change) <= NOPRESSRETURNTIME) return;
 
     /* Handle long button inactivity. */
-    if (menus->active->parent != NULL) {
-	menus->active = menus->active->parent;
-	menus->act_flags &=
-	    ~FLAG(menus->active->children[menus->active->ci].id);
+    if (menus->depth > 0) {
+	menu_leave(menus);
 
 	/* Adjust element to remove the message if present. */
-        adjust_element(ADJ_MENUCHANGE, menus->act_flags, &menus->msg, values,
-		       inv_enable);
+        adjust_element(ADJ_MENUCHANGE, menus, mvs, inv_enable);
 
 	*menu_change = thistime;
-        print_menu(menus->root, menus->active);
+        print_menu(menus);
 
 	/* Save changes if any to eeprom, on idle. */
-	if (menus->active == menus->root) {
+	if (menus->depth == 0) {
 
 	    /*
 	     * This would generate 4 bytes more machine-code:
@@ -1524,14 +1667,6 @@ button_is_up(
 	    } else {
 	        cfg_save(false);
 	    }
-
-	    /*
-	     * Set values to zero so that they can be used to calculate
-	     * averages. See print_elements().
-	     */
-	    for (uint8_t sensor = SENSOR0; sensor < SENSOR_COUNT; sensor++) {
-		values[sensor] = 0;
-	    }
 	}
     }
 #undef NOPRESSRETURNTIME
@@ -1666,7 +1801,7 @@ sensor_request(
 {
 #define PRINTTIME 100
 #define BOUNCETIME 50
-    static menus_t		*menus = NULL;		/* menu structure */
+    static menus_t		menus;			/* menu state */
     static sensor_t		*sensors = NULL;	/* usable sensors */
     static bool			sensor_low = false;	/* sensor state */
     static unsigned long	sensor_ch = millis();	/* last sensor change */
@@ -1674,15 +1809,12 @@ sensor_request(
     static unsigned long 	printtime = millis();	/* print timestamp */
     static unsigned long 	bouncetime = millis();	/* bounce timestamp */
     unsigned long 		thistime = millis();	/* current timestamp */
-    static float		values[SENSOR_COUNT];	/* sensor values */
+    static int32_t		mvs[SENSOR_COUNT];	/* sensor values (mV) */
     static bool			inv_enable = false;	/* whether enable
 							   should be inversed
 							   on save */
 
     /* Initialise once. */
-    if (menus == NULL) {
-        menus = menus_init();
-    }
     if (sensors == NULL) {
 	sensors = control_init();
 	/*
@@ -1691,7 +1823,7 @@ sensor_request(
 	 * sensor starts, an uninitialised value would be used.
 	 * See button_goes_up() for more info.
 	 */
-	read_sensors(values);
+	read_sensors(mvs);
     }
     if (check_fontreset && sensors != NULL) {
 	uint8_t count;	/* number of usable sensors during previous call */
@@ -1711,16 +1843,12 @@ sensor_request(
     }
 
     /*
-     * Print element values a number of times per second. Too fast would result
-     * in flickering (only when manipulating elements using menus) because
-     * clearing/filling the screen buffer and printing it are done
-     * asynchronous. We want to avoid too many empty screen prints.
+     * Print element values a number of times per second. Only characters
+     * that changed are written to the Max7456, so most prints cost nothing.
      */
     if (thistime - printtime > PRINTTIME) {
-	if (menus->active == menus->root
-	    || menus->active->children == NULL) {
-	    print_elements(menus->act_flags, thistime, menus->msg,
-		           values);
+	if (menus.depth == 0 || menu_children(&menus) == NULL) {
+	    print_elements(menus.depth > 0, thistime, menus.msg);
 	}
 	printtime = thistime;
     }
@@ -1740,11 +1868,11 @@ sensor_request(
 	 */
 	if (thistime - bouncetime > BOUNCETIME) {
 	    if (sensor_ch < bouncetime) {
-		button_goes_down(menus, thistime, sensor_ch, &menu_ch, values,
+		button_goes_down(&menus, thistime, sensor_ch, &menu_ch, mvs,
 			         &inv_enable);
 		sensor_ch = thistime;
 	    }
-	    button_is_down(menus, thistime, sensor_ch, &menu_ch, values,
+	    button_is_down(&menus, thistime, sensor_ch, &menu_ch, mvs,
 		           &inv_enable);
 	}
     } else {
@@ -1758,11 +1886,11 @@ sensor_request(
 	/* Debouncing, see comment above. */
 	if (thistime - bouncetime > BOUNCETIME) {
 	    if (sensor_ch < bouncetime) {
-		button_goes_up(menus, thistime, sensor_ch, &menu_ch, values,
+		button_goes_up(&menus, thistime, sensor_ch, &menu_ch, mvs,
 			       &inv_enable);
 		sensor_ch = thistime;
 	    }
-	    button_is_up(menus, thistime, sensor_ch, &menu_ch, values,
+	    button_is_up(&menus, thistime, sensor_ch, &menu_ch, mvs,
 		         &inv_enable);
 	}
     }
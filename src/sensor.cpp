@@ -28,10 +28,13 @@
 #define __STDC_LIMIT_MACROS
 
 #include <Arduino.h>
+#include <EEPROM.h>
 #include <stdint.h>
+#include <util/atomic.h>
 #include "hardware.h"
 #include "config.h"
 #include "sensor.h"
+#include "alarm.h"
 
 //Workaround for http://gcc.gnu.org/bugzilla/show_bug.cgi?id=34734
 #ifdef PROGMEM
@@ -39,10 +42,293 @@
 #define PROGMEM __attribute__((section(".progmem.data")))
 #endif
 
+#define RINGSIZE	(8)	/* samples per sensor, must be a power of 2 */
+#define OVERSAMPLE_MAX	(3)	/* max. number of extra bits by oversampling */
+#define FRACBITS	(OVERSAMPLE_MAX)	/* fraction bits of samples */
+#define RAWMAX		(1023 << FRACBITS)	/* max. sample value */
+#define TICKRATE	(10)	/* integrator ticks per second */
+#define MAHUNITS	(36000UL * TICKRATE)	/* charge units per mAh */
+#define MAHMAX		(0x00FFFFFEUL)	/* max. storable charge in mAh */
+#define HISTPERIOD	(TICKRATE)	/* initial ticks per history entry */
+#define HISTPERIOD_MAX	(32768U)	/* max. ticks per history entry */
+
+/* ADC channels of the sensors, in order of sensor_t. */
+const uint8_t SENSORCHANNELS[SENSOR_COUNT] PROGMEM = {
+    ATMEL_SENS0PIN - A0,
+    ATMEL_SENS1PIN - A0,
+    ATMEL_SENS2PIN - A0,
+    ATMEL_SENS3PIN - A0
+};
+
+/*
+ * LiPo cell state of charge; open cell voltage in mV at 0%, 2%, .. 100%.
+ * Same data as $lipogauge in examples/battery.php.
+ */
+#define LIPOSTEP	(2)	/* percentage step of LIPOGAUGE */
+const uint16_t LIPOGAUGE[] PROGMEM = {
+    3000, 3431, 3508, 3573, 3630, 3671, 3695, 3705,
+    3710, 3719, 3725, 3731, 3739, 3744, 3752, 3759,
+    3763, 3770, 3778, 3788, 3795, 3800, 3807, 3817,
+    3827, 3837, 3843, 3847, 3857, 3865, 3876, 3887,
+    3896, 3905, 3915, 3925, 3935, 3945, 3964, 3974,
+    3984, 3998, 4013, 4028, 4042, 4062, 4086, 4101,
+    4135, 4170, 4200
+};
+
+/*
+ * Background sampler data. The ADC interrupt handler samples all sensors
+ * round-robin and accumulates 4^n conversions per sensor, where n is the
+ * configured number of extra bits (OVERSAMPLE). The accumulated value is
+ * decimated to a 10+n bits sample, which is stored with FRACBITS fraction
+ * bits in a small ring buffer. A running sum makes it cheap to get the
+ * filtered value.
+ */
+static volatile uint16_t	rings[SENSOR_COUNT][RINGSIZE];	/* samples */
+static volatile uint16_t	sums[SENSOR_COUNT];	/* sums of rings */
+static volatile uint16_t	accs[SENSOR_COUNT];	/* oversampling sums */
+static volatile uint8_t		acccount;	/* conversions per sensor */
+static volatile uint8_t		ringidx;	/* next index in rings */
+static volatile uint8_t		cursensor;	/* sensor being sampled */
+
+/*
+ * Charge integrator data. The timer interrupt handler converts the CURR
+ * sensor voltage to current at a fixed rate and accumulates it. One charge
+ * unit is the current of one CURRSCALE unit (0.1 mA) during one tick.
+ */
+static volatile uint32_t	charge;		/* consumed charge in mAh */
+static volatile uint32_t	chargefrac;	/* fraction in charge units */
+static uint32_t			chargesaved;	/* charge in eeprom */
+static uint8_t			chargeslot;	/* last used eeprom slot */
+
+/*
+ * Sample snapshot, taken by the timer interrupt handler once per tick and
+ * processed by sensor_task(). Access from elsewhere only within an atomic
+ * block, which also acts as memory barrier.
+ */
+static volatile int32_t		tickmvs[SENSOR_COUNT];	/* voltages in mV */
+static volatile uint8_t		ticks;		/* unprocessed ticks */
+
+/* Statistics data, updated by sensor_task(). */
+static sensorstats_t		stats[SENSOR_COUNT];	/* per sensor */
+static uint32_t			histaccs[SENSOR_COUNT];	/* history sums */
+static uint16_t			histticks;	/* ticks in history sums */
+static uint16_t			histperiod;	/* ticks per history entry */
+static uint8_t			histlen;	/* used history entries */
+
+/* Subscription data, see sensor_subscribe(). */
+static uint8_t			submask;	/* subscribed sensors */
+static uint16_t			subinterval;	/* report interval (ms) */
+static uint16_t			subdeadband;	/* min. change (mV) */
+static unsigned long		sublast;	/* time of last check */
+static int32_t			subvals[SENSOR_COUNT];	/* reported mV */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: ISR(ADC_vect)
+ *  Purpose	: ADC conversion complete interrupt handler.
+ *  Method	: Accumulate conversion, decimate and store in ring buffers
+ *  		  when all oversampling conversions are done, select next
+ *  		  sensor's channel, start next conversion.
+ *
+ *  A single conversion takes 13 ADC clock cycles of 8 us (16 MHz with
+ *  prescaler 128), so each sensor is converted about 2400 times per second.
+ *  With e.g. 2 extra bits (16x oversampling), that's 150 samples per second.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+ISR(ADC_vect)
+{
+    uint8_t	sensor;	/* sensor id */
+    uint8_t	bits;	/* number of extra bits */
+    uint16_t	val;	/* decimated sample */
+
+    sensor = cursensor;
+    accs[sensor] += ADC;
+    if (++sensor == SENSOR_COUNT) {
+	sensor = 0;
+	if ((bits = cfg_get_oversample()) > OVERSAMPLE_MAX) {
+	    bits = OVERSAMPLE_MAX;
+	}
+	if (++acccount >= (1 << (2 * bits))) {
+	    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+		val = (accs[i] >> bits) << (FRACBITS - bits);
+		sums[i] += val - rings[i][ringidx];
+		rings[i][ringidx] = val;
+		accs[i] = 0;
+	    }
+	    ringidx = (ringidx + 1) & (RINGSIZE - 1);
+	    acccount = 0;
+	}
+    }
+    cursensor = sensor;
+    ADMUX = (ADMUX & 0xF0) | pgm_read_byte(&SENSORCHANNELS[sensor]);
+    ADCSRA |= _BV(ADSC);
+} /* ISR(ADC_vect) */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_charge_tick
+ *  Purpose	: Integrate current of the CURR sensor.
+ *  Method	: Convert voltage to current and accumulate.
+ *
+ *  The current is the sensor voltage minus CURROFFS (mV), times CURRSCALE
+ *  (mA per 10 mV). Using the filtered sample at a fixed rate of TICKRATE
+ *  per second is accurate enough, as the sampler runs much faster.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+sensor_charge_tick(
+    int32_t	mv)	/* CURR sensor voltage in mV */
+{
+    uint16_t	scale;	/* current scale */
+
+    if ((scale = cfg_get_currscale()) == 0) return;
+    if ((mv -= cfg_get_curroffs()) <= 0) return;
+    chargefrac += (uint32_t)mv * scale;
+    if (chargefrac >= MAHUNITS) {
+	charge += chargefrac / MAHUNITS;
+	chargefrac %= MAHUNITS;
+	if (charge > MAHMAX) charge = MAHMAX;
+    }
+} /* sensor_charge_tick() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_stats_tick
+ *  Purpose	: Update statistics of all sensors.
+ *  Method	: Update min, max and sum, add to history when a history
+ *  		  period has passed.
+ *
+ *  The history holds up to SENSOR_HISTSIZE averages over a period that
+ *  starts at HISTPERIOD ticks. When the history is full, adjacent entries
+ *  are merged and the period doubles, so that the history always covers
+ *  the entire session. The running average just continues to fill the
+ *  doubled period. Once the period can't grow anymore, the oldest entry is
+ *  dropped instead.
+ *  When the sum of a sensor would overflow, both its sum and count are
+ *  halved. So after many hours, the mean gradually favours recent samples.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+sensor_stats_tick(
+    const int32_t	*mv)	/* voltages of all sensors in mV */
+{
+    sensorstats_p	st;		/* statistics of a sensor */
+    bool		push;		/* whether to add history entry */
+    bool		merge = false;	/* whether to merge entries */
+    bool		shift = false;	/* whether to drop oldest entry */
+    uint8_t		j;		/* history index */
+
+    push = ++histticks >= histperiod;
+    if (push && histlen == SENSOR_HISTSIZE) {
+	if (histperiod <= HISTPERIOD_MAX / 2) {
+	    merge = true;
+	    push = false;
+	} else {
+	    shift = true;
+	}
+    }
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+	st = &stats[i];
+	if (mv[i] < st->min) st->min = mv[i];
+	if (mv[i] > st->max) st->max = mv[i];
+	if (st->sum > UINT32_MAX - UINT16_MAX) {
+	    st->sum >>= 1;
+	    st->count >>= 1;
+	}
+	st->sum += mv[i];
+	st->count++;
+	histaccs[i] += mv[i];
+	if (merge) {
+	    for (j = 0; j < SENSOR_HISTSIZE / 2; j++) {
+		st->hist[j] = ((uint32_t)st->hist[2 * j]
+			       + st->hist[2 * j + 1] + 1) / 2;
+	    }
+	} else if (shift) {
+	    for (j = 0; j < SENSOR_HISTSIZE - 1; j++) {
+		st->hist[j] = st->hist[j + 1];
+	    }
+	}
+	if (push) {
+	    st->hist[shift ? SENSOR_HISTSIZE - 1 : histlen] =
+		(histaccs[i] + histticks / 2) / histticks;
+	    histaccs[i] = 0;
+	}
+    }
+    if (merge) {
+	histlen = SENSOR_HISTSIZE / 2;
+	histperiod *= 2;
+    } else if (push) {
+	if (!shift) histlen++;
+	histticks = 0;
+    }
+} /* sensor_stats_tick() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: ISR(TIMER1_COMPA_vect)
+ *  Purpose	: Timer1 compare match interrupt handler.
+ *  Method	: Take a sample snapshot and integrate current at a fixed
+ *  		  rate.
+ *
+ *  Statistics and alarms are left to sensor_task(), which runs from the
+ *  main loop, to keep this handler short.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+ISR(TIMER1_COMPA_vect)
+{
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+	tickmvs[i] = sensor_get_mv((sensor_t)i);
+    }
+    sensor_charge_tick(tickmvs[SENSOR3]);
+    if (ticks < UINT8_MAX) ticks++;
+} /* ISR(TIMER1_COMPA_vect) */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_task
+ *  Purpose	: Update statistics and evaluate alarms.
+ *  Method	: Copy the sample snapshot in an atomic block, process it once
+ *  		  for each tick since the last run.
+ *
+ *  Statistics are kept per tick, so ticks missed by a late run are made up
+ *  with the latest snapshot.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+sensor_task(void)
+{
+    int32_t	mv[SENSOR_COUNT];	/* sensor voltages in mV */
+    uint8_t	n;			/* ticks to process */
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	n = ticks;
+	ticks = 0;
+	for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+	    mv[i] = tickmvs[i];
+	}
+    }
+    if (n == 0) return;
+    while (n-- > 0) {
+	sensor_stats_tick(mv);
+    }
+    alarm_tick(mv);
+} /* sensor_task() */
+
+
 /*------------------------------------------------------------------------
  *  Function	: sensor_setup
  *  Purpose	: Setup the sensor board.
- *  Method	: Set sensor pin modes.
+ *  Method	: Set sensor pin modes, start background sampler.
  *
  *  The Micro MinimOSD board with KV-mod uses a 1k/14k6 resistor divider at
  *  pins VBAT1/VBAT2 so that a full scale measurement will be a bit more than
@@ -65,60 +351,158 @@ sensor_setup(
     pinMode(ATMEL_SENS1PIN, INPUT);
     pinMode(ATMEL_SENS2PIN, INPUT);
     pinMode(ATMEL_SENS3PIN, INPUT);
-    analogReference(INTERNAL);	/* internal 1.1V */
+
+    /*
+     * Start the background sampler with the internal 1.1V reference and
+     * prescaler 128. Each conversion complete interrupt starts the next one.
+     */
+    cursensor = SENSOR0;
+    ADMUX = _BV(REFS1) | _BV(REFS0)
+	| pgm_read_byte(&SENSORCHANNELS[SENSOR0]);
+    ADCSRA = _BV(ADEN) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0)
+	| _BV(ADSC);
 
     /*
      * The first few measurements may be inaccurate after changing the
-     * reference voltage. So we do them here.
+     * reference voltage. So we give the reference time to settle, and then
+     * wait for the ring buffers to be filled with stable samples.
+     */
+    delay(20);
+    for (uint8_t i = 0; i <= RINGSIZE; i++) {
+	uint8_t idx = ringidx;	/* current ring buffer index */
+
+	while (ringidx == idx);
+    }
+
+    /*
+     * Start the charge integrator and statistics. Timer1 is only used by the Arduino
+     * framework for PWM at pins 9 and 10, which we don't use. In CTC mode
+     * with prescaler 256 it counts at 62500 Hz.
      */
-    sensor_get_value(SENSOR0);
-    sensor_get_value(SENSOR1);
-    sensor_get_value(SENSOR2);
-    sensor_get_value(SENSOR3);
+    sensor_reset_stats();
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS12);
+    OCR1A = F_CPU / 256 / TICKRATE - 1;
+    TCNT1 = 0;
+    TIMSK1 |= _BV(OCIE1A);
 } /* sensor_setup() */
 
 
 /*------------------------------------------------------------------------
- *  Function	: sensor_get_value
- *  Purpose	: Get voltage of requested sensor.
- *  Method	: Use inbuilt resistor voltage divider and ATmega328 ADC set
- *  		  to 1.1V reference voltage.
+ *  Function	: sensor_mult
+ *  Purpose	: Get multiplier that converts raw sensor readout to mV.
+ *  Method	: Recalculate multiplier from calibration value only when the
+ *  		  latter has changed.
  *
- *  Returns	: The measured voltage in volts, negative on error.
+ *  The multiplier is a Q16.16 fixed-point value, so that
+ *  mV = (sample * multiplier) >> 16, where sample is the filtered value
+ *  including FRACBITS fraction bits. For sensors 0 and 1 one calibration unit
+ *  is 1 mV at full scale; for sensors 2 and 3 it is 0.1 mV. Note that
+ *  RAWMAX * multiplier stays just within 32 bits for the maximum calibration
+ *  value.
+ *
+ *  Returns	: The multiplier, 0 on error.
  *------------------------------------------------------------------------
  */
-float
-sensor_get_value(
+static uint32_t
+sensor_mult(
     sensor_t 	sensor)	/* sensor id */
 {
-    uint8_t 	pin;	/* hardware sensor pin */
-    uint16_t	sensadj;/* calibrated value */
-    float	factor;	/* multiplication factor */
+    static uint16_t	sensadjs[SENSOR_COUNT];	/* calibration values used */
+    static uint32_t	mults[SENSOR_COUNT];	/* calculated multipliers */
+    uint16_t		sensadj;		/* calibrated value */
+    uint8_t		div;			/* calibration unit divider */
+    uint32_t		mult;			/* multiplier */
 
     switch (sensor) {
 	case SENSOR0:
-	    pin = ATMEL_SENS0PIN;
 	    sensadj = cfg_get_sensadj0();
-	    factor = 0.001;
+	    div = 1;
 	    break;
 	case SENSOR1:
-	    pin = ATMEL_SENS1PIN;
 	    sensadj = cfg_get_sensadj1();
-	    factor = 0.001;
+	    div = 1;
 	    break;
 	case SENSOR2:
-	    pin = ATMEL_SENS2PIN;
 	    sensadj = cfg_get_sensadj2();
-	    factor = 0.0001;
+	    div = 10;
 	    break;
 	case SENSOR3:
-	    pin = ATMEL_SENS3PIN;
 	    sensadj = cfg_get_sensadj3();
-	    factor = 0.0001;
+	    div = 10;
 	    break;
-	default: return -1;
+	default: return 0;
+    }
+    /* The integrator may use the multiplier too, so update atomically. */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	if (sensadj != sensadjs[sensor] || mults[sensor] == 0) {
+	    sensadjs[sensor] = sensadj;
+	    mults[sensor] =
+		((uint32_t)sensadj << 16) / (div * (uint32_t)RAWMAX);
+	}
+	mult = mults[sensor];
+    }
+    return mult;
+} /* sensor_mult() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_get_sample
+ *  Purpose	: Get filtered sensor sample.
+ *  Method	: Average the ring buffer of the background sampler.
+ *
+ *  Returns	: The sample including FRACBITS fraction bits, negative on
+ *  		  error.
+ *------------------------------------------------------------------------
+ */
+static int16_t
+sensor_get_sample(
+    sensor_t 	sensor)	/* sensor id */
+{
+    uint16_t	sum;	/* sum of samples */
+
+    if (sensor < SENSOR0 || sensor >= SENSOR_COUNT) return -1;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	sum = sums[sensor];
     }
-    return factor * (float)sensadj * analogRead(pin) / (float)1023;
+    return (sum + RINGSIZE / 2) / RINGSIZE;
+} /* sensor_get_sample() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_get_mv
+ *  Purpose	: Get voltage of requested sensor in millivolts.
+ *  Method	: Multiply filtered sample by fixed-point multiplier.
+ *
+ *  Returns	: The measured voltage in mV, negative on error.
+ *------------------------------------------------------------------------
+ */
+int32_t
+sensor_get_mv(
+    sensor_t 	sensor)	/* sensor id */
+{
+    int16_t	sample;	/* filtered sensor sample */
+
+    if ((sample = sensor_get_sample(sensor)) < 0) return -1;
+    return ((uint32_t)sample * sensor_mult(sensor)) >> 16;
+} /* sensor_get_mv() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_get_value
+ *  Purpose	: Get voltage of requested sensor.
+ *  Method	: Convert millivolts to volts.
+ *
+ *  This is for calibration only, use sensor_get_mv() otherwise.
+ *
+ *  Returns	: The measured voltage in volts, negative on error.
+ *------------------------------------------------------------------------
+ */
+float
+sensor_get_value(
+    sensor_t 	sensor)	/* sensor id */
+{
+    return sensor_get_mv(sensor) / (float)1000;
 }  /* sensor_get_value() */
 
 
@@ -135,66 +519,320 @@ sensor_set_value(
     sensor_t 	sensor,			/* sensor id */
     float	voltage)		/* voltage to set */
 {
-    uint8_t 	pin;			/* hardware sensor pin */
     bool 	(*sensadj)(uint16_t);	/* calibration function */
     float	factor;			/* multiplication factor */
 
     switch (sensor) {
 	case SENSOR0:
-	    pin = ATMEL_SENS0PIN;
 	    sensadj = cfg_set_sensadj0;
 	    factor = 0.001;
 	    break;
 	case SENSOR1:
-	    pin = ATMEL_SENS1PIN;
 	    sensadj = cfg_set_sensadj1;
 	    factor = 0.001;
 	    break;
 	case SENSOR2:
-	    pin = ATMEL_SENS2PIN;
 	    sensadj = cfg_set_sensadj2;
 	    factor = 0.0001;
 	    break;
 	case SENSOR3:
-	    pin = ATMEL_SENS3PIN;
 	    sensadj = cfg_set_sensadj3;
 	    factor = 0.0001;
 	    break;
 	default: return false;
     }
-    return sensadj(voltage * (float)1023 / (factor * analogRead(pin)));
+    return sensadj(voltage * (float)RAWMAX
+		   / (factor * sensor_get_sample(sensor)));
 } /* sensor_set_value() */
 
 
 /*------------------------------------------------------------------------
  *  Function	: sensor_get_raw
  *  Purpose	: Get raw sensor readout.
- *  Method	: Use inbuilt resistor voltage divider and ATmega328 ADC set
- *  		  to 1.1V reference voltage.
+ *  Method	: Round filtered sample to 10 bits ADC resolution.
  *
- *  Returns	: The measures voltage in units.
+ *  Returns	: The measured voltage in units, negative on error.
  *------------------------------------------------------------------------
  */
 int16_t
 sensor_get_raw(
     sensor_t 	sensor)	/* sensor id */
 {
-    uint8_t 	pin;	/* hardware sensor pin */
+    int16_t	sample;	/* filtered sensor sample */
 
-    switch (sensor) {
-	case SENSOR0:
-	    pin = ATMEL_SENS0PIN;
-	    break;
-	case SENSOR1:
-	    pin = ATMEL_SENS1PIN;
-	    break;
-	case SENSOR2:
-	    pin = ATMEL_SENS2PIN;
-	    break;
-	case SENSOR3:
-	    pin = ATMEL_SENS3PIN;
+    if ((sample = sensor_get_sample(sensor)) < 0) return -1;
+    return (sample + (1 << (FRACBITS - 1))) >> FRACBITS;
+} /* sensor_get_raw() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_get_mah
+ *  Purpose	: Get consumed or remaining charge.
+ *  Method	: Read integrator, subtract from capacity if requested.
+ *
+ *  Returns	: The charge in mAh, negative on error (remaining charge
+ *  		  requested while no CAPACITY is configured).
+ *------------------------------------------------------------------------
+ */
+int32_t
+sensor_get_mah(
+    bool 	remaining)	/* whether to get remaining charge */
+{
+    uint32_t	mah;		/* consumed charge */
+    uint16_t	capacity;	/* battery capacity */
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	mah = charge;
+    }
+    if (!remaining) return mah;
+    if ((capacity = cfg_get_capacity()) == 0) return -1;
+    return mah < capacity ? capacity - mah : 0;
+} /* sensor_get_mah() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_reset_mah
+ *  Purpose	: Reset consumed charge.
+ *  Method	: Clear integrator and save to eeprom.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+sensor_reset_mah(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	charge = 0;
+	chargefrac = 0;
+    }
+    sensor_save_mah();
+} /* sensor_reset_mah() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_load_mah
+ *  Purpose	: Restore consumed charge from eeprom.
+ *  Method	: Find last written slot and read its value if MAHKEEP is set.
+ *
+ *  Each slot holds a 24 bits charge and an 8 bits sequence number, the
+ *  latter being written last. A slot is the last written one if the next
+ *  slot doesn't continue its sequence. An erased eeprom (all 0xFF) yields
+ *  slot 0 with an invalid charge, which is read as zero.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+sensor_load_mah(void)
+{
+    uint8_t	seq;	/* sequence number of slot */
+    uint8_t	next;	/* sequence number of next slot */
+    uint16_t	addr;	/* eeprom address of slot */
+    uint32_t	mah;	/* stored charge */
+
+    chargeslot = 0;
+    next = EEPROM.read(EEPROM_MAH_ADDR + 3);
+    for (uint8_t i = 0; i < EEPROM_MAH_SLOTS; i++) {
+	seq = next;
+	next = EEPROM.read(EEPROM_MAH_ADDR
+			   + 4 * ((i + 1) % EEPROM_MAH_SLOTS) + 3);
+	if (next != (uint8_t)(seq + 1)) {
+	    chargeslot = i;
 	    break;
-	default: return -1;
+	}
     }
-    return analogRead(pin);
-} /* sensor_get_raw() */
+    addr = EEPROM_MAH_ADDR + 4 * chargeslot;
+    mah = 0;
+    for (uint8_t i = 3; i > 0; i--) {
+	mah = (mah << 8) | EEPROM.read(addr + i - 1);
+    }
+    if (mah > MAHMAX) mah = 0;
+    chargesaved = mah;
+    if (!cfg_get_mahkeep()) mah = 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	charge = mah;
+	chargefrac = 0;
+    }
+} /* sensor_load_mah() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_save_mah
+ *  Purpose	: Save consumed charge to eeprom.
+ *  Method	: Write value to next slot if changed and MAHKEEP is set.
+ *
+ *  Only changed bytes are written. Saving once a minute spreads over 16
+ *  slots lasts for years of continuous use.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+sensor_save_mah(void)
+{
+    uint32_t	mah;	/* consumed charge */
+    uint8_t	seq;	/* sequence number */
+    uint16_t	addr;	/* eeprom address of slot */
+    uint8_t	val;	/* byte to write */
+
+    if (!cfg_get_mahkeep()) return;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+	mah = charge;
+    }
+    if (mah == chargesaved) return;
+    seq = EEPROM.read(EEPROM_MAH_ADDR + 4 * chargeslot + 3) + 1;
+    chargeslot = (chargeslot + 1) % EEPROM_MAH_SLOTS;
+    addr = EEPROM_MAH_ADDR + 4 * chargeslot;
+    for (uint8_t i = 0; i < 4; i++) {
+	val = i < 3 ? (uint8_t)(mah >> (8 * i)) : seq;
+	if (val != EEPROM.read(addr + i)) {	/* prevent unnecessary wear */
+	    EEPROM.write(addr + i, val);
+	}
+    }
+    chargesaved = mah;
+} /* sensor_save_mah() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_subscribe
+ *  Purpose	: Subscribe to periodic sensor reports.
+ *  Method	: Store parameters and forget previously reported values.
+ *
+ *  Each bit in the mask selects a sensor, bit 0 being sensor 0. An interval
+ *  or mask of 0 ends the subscription. Sensors are only reported if their
+ *  voltage changed at least deadband mV since their previous report. All
+ *  selected sensors are reported at the first interval.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+sensor_subscribe(
+    uint8_t 	mask,		/* sensors to report */
+    uint16_t 	interval,	/* report interval in ms */
+    uint16_t 	deadband)	/* min. change in mV */
+{
+    if (mask >= (1 << SENSOR_COUNT)) return false;
+    submask = interval > 0 ? mask : 0;
+    subinterval = interval;
+    subdeadband = deadband;
+    sublast = millis() - interval;
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+	subvals[i] = -1;
+    }
+    return true;
+} /* sensor_subscribe() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_report
+ *  Purpose	: Get sensor values to report for subscription.
+ *  Method	: Check interval, compare voltages with reported values.
+ *
+ *  Returns	: Mask of sensors to report, values in mV are stored in mv.
+ *------------------------------------------------------------------------
+ */
+uint8_t
+sensor_report(
+    int32_t 	*mv)		/* SENSOR_COUNT values */
+{
+    unsigned long	thistime;	/* current timestamp */
+    uint8_t		mask = 0;	/* sensors to report */
+    int32_t		diff;		/* voltage change */
+
+    if (submask == 0) return 0;
+    thistime = millis();
+    if (thistime - sublast < subinterval) return 0;
+    sublast = thistime;
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+	if ((submask & (1 << i)) == 0) continue;
+	mv[i] = sensor_get_mv((sensor_t)i);
+	diff = mv[i] - subvals[i];
+	if (subvals[i] < 0 || diff >= subdeadband || -diff >= subdeadband) {
+	    subvals[i] = mv[i];
+	    mask |= 1 << i;
+	}
+    }
+    return mask;
+} /* sensor_report() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_reset_stats
+ *  Purpose	: Reset statistics of all sensors.
+ *  Method	: Clear data.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+sensor_reset_stats(void)
+{
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+	stats[i].min = UINT16_MAX;
+	stats[i].max = 0;
+	stats[i].sum = 0;
+	stats[i].count = 0;
+	histaccs[i] = 0;
+    }
+    histticks = 0;
+    histperiod = HISTPERIOD;
+    histlen = 0;
+} /* sensor_reset_stats() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_get_stats
+ *  Purpose	: Get statistics of requested sensor.
+ *  Method	: Copy data.
+ *
+ *  Returns	: Number of history entries, negative on error.
+ *------------------------------------------------------------------------
+ */
+int8_t
+sensor_get_stats(
+    sensor_t 		sensor,	/* sensor id */
+    sensorstats_p	st,	/* statistics */
+    uint32_t		*period)/* history period in ms */
+{
+    if (sensor < SENSOR0 || sensor >= SENSOR_COUNT) return -1;
+    *st = stats[sensor];
+    *period = (uint32_t)histperiod * 1000 / TICKRATE;
+    return histlen;
+} /* sensor_get_stats() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: sensor_lipo_percent
+ *  Purpose	: Get LiPo state of charge from cell voltage.
+ *  Method	: Binary search in LIPOGAUGE, interpolate linearly.
+ *
+ *  Returns	: Percentage 0..100.
+ *------------------------------------------------------------------------
+ */
+uint8_t
+sensor_lipo_percent(
+    int32_t 	mv)	/* cell voltage in mV */
+{
+    uint8_t	lo = 0;		/* lower index of segment */
+    uint8_t	hi;		/* upper index of segment */
+    uint8_t	mid;		/* middle index */
+    uint16_t	vlo;		/* voltage at lo */
+    uint16_t	vhi;		/* voltage at hi */
+
+    hi = sizeof(LIPOGAUGE) / sizeof(LIPOGAUGE[0]) - 1;
+    if (mv <= (int32_t)pgm_read_word(&LIPOGAUGE[lo])) return 0;
+    if (mv >= (int32_t)pgm_read_word(&LIPOGAUGE[hi])) return 100;
+    while (hi - lo > 1) {
+	mid = (lo + hi) / 2;
+	if (mv < (int32_t)pgm_read_word(&LIPOGAUGE[mid])) {
+	    hi = mid;
+	} else {
+	    lo = mid;
+	}
+    }
+    vlo = pgm_read_word(&LIPOGAUGE[lo]);
+    vhi = pgm_read_word(&LIPOGAUGE[hi]);
+    return lo * LIPOSTEP
+	+ ((uint16_t)(mv - vlo) * LIPOSTEP + (vhi - vlo) / 2) / (vhi - vlo);
+} /* sensor_lipo_percent() */
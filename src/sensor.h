@@ -37,13 +37,45 @@ typedef enum sensor_t {		/* voltage sensor ids */
 
 #define SENSOR_COUNT SENSOR_NONE
 
+#define SENSOR_HISTSIZE (8)	/* max. number of history entries */
+
+typedef struct sensorstats_t {	/* sensor statistics */
+    uint16_t	min;		/* min. voltage in mV */
+    uint16_t	max;		/* max. voltage in mV */
+    uint32_t	sum;		/* sum of voltages in mV */
+    uint32_t	count;		/* number of samples */
+    uint16_t	hist[SENSOR_HISTSIZE];	/* average voltages in mV */
+} sensorstats_t, *sensorstats_p;
+
 void sensor_setup(bool);
 
+int32_t sensor_get_mv(sensor_t);
+
 float sensor_get_value(sensor_t);
 
 bool sensor_set_value(sensor_t, float);
 
 int16_t sensor_get_raw(sensor_t);
 
+int32_t sensor_get_mah(bool);
+
+void sensor_reset_mah(void);
+
+void sensor_load_mah(void);
+
+void sensor_save_mah(void);
+
+bool sensor_subscribe(uint8_t, uint16_t, uint16_t);
+
+uint8_t sensor_report(int32_t *);
+
+void sensor_task(void);
+
+void sensor_reset_stats(void);
+
+int8_t sensor_get_stats(sensor_t, sensorstats_p, uint32_t *);
+
+uint8_t sensor_lipo_percent(int32_t);
+
 #endif /* SENSOR_H */
 
@@ -0,0 +1,183 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: task.cpp
+ *  Purpose	: Background task scheduling.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+#include "max7456.h"
+#include "sensor.h"
+#include "font.h"
+#include "alarm.h"
+#include "task.h"
+
+//Workaround for http://gcc.gnu.org/bugzilla/show_bug.cgi?id=34734
+#ifdef PROGMEM
+#undef PROGMEM
+#define PROGMEM __attribute__((section(".progmem.data")))
+#endif
+
+static void task_font(void);
+
+/* X-macro generating task functions. */
+void (* const TASKFUNCS[])(void) PROGMEM = {
+#define X(key, func, period, phase, budget) func,
+    TASK_TABLE
+#undef X
+};
+
+/* X-macro generating task budgets. */
+const uint16_t TASKBUDGETS[] PROGMEM = {
+#define X(key, func, period, phase, budget) budget,
+    TASK_TABLE
+#undef X
+};
+
+static unsigned long	tasklast[TASK_COUNT];	/* scheduled time of last run */
+static taskstats_t	taskstats[TASK_COUNT];	/* task statistics */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: task_font
+ *  Purpose	: Proceed with background font job.
+ *  Method	: Use font routine.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+task_font(void)
+{
+    font_task();
+} /* task_font() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: task_period
+ *  Purpose	: Get period of task.
+ *  Method	: X-macro generated switch, so periods may be expressions.
+ *
+ *  Returns	: Period in ms.
+ *------------------------------------------------------------------------
+ */
+static unsigned long
+task_period(
+    uint8_t 	task)	/* task id */
+{
+    switch (task) {
+#define X(key, func, period, phase, budget) case key: return (period);
+    TASK_TABLE
+#undef X
+    }
+    return 0;
+} /* task_period() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: task_setup
+ *  Purpose	: Initialise task schedule.
+ *  Method	: Pretend that each task ran one period before its phase.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+task_setup(void)
+{
+    unsigned long	thistime = millis();	/* current timestamp */
+
+#define X(key, func, period, phase, budget) \
+    tasklast[key] = thistime + (phase) - task_period(key);
+    TASK_TABLE
+#undef X
+} /* task_setup() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: task_run
+ *  Purpose	: Run next due background task, if any.
+ *  Method	: Round robin, starting after the task that ran last.
+ *
+ *  At most one task runs per call, so that the main loop gets back to
+ *  serving requests quickly. A task that is late keeps its phase, unless
+ *  it missed a whole period; then it's rescheduled from now.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+void
+task_run(void)
+{
+    static uint8_t	next;			/* task to check first */
+    unsigned long	thistime = millis();	/* current timestamp */
+    unsigned long	period;			/* task period in ms */
+    unsigned long	late;			/* start delay in ms */
+    unsigned long	start;			/* start time in us */
+    unsigned long	elapsed;		/* execution time in us */
+    uint8_t		task;			/* task id */
+    taskstats_p		st;			/* task statistics */
+
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+	task = (next + i) % TASK_COUNT;
+	period = task_period(task);
+	if (thistime - tasklast[task] < period) continue;
+	st = &taskstats[task];
+	late = thistime - tasklast[task] - period;
+	if (late > st->maxlate) st->maxlate = late > 0xFFFF ? 0xFFFF : late;
+	tasklast[task] += period;
+	if (thistime - tasklast[task] >= period) tasklast[task] = thistime;
+
+	start = micros();
+	((void (*)(void))pgm_read_word(&TASKFUNCS[task]))();
+	elapsed = micros() - start;
+	if (elapsed > st->maxtime) {
+	    st->maxtime = elapsed > 0xFFFF ? 0xFFFF : elapsed;
+	}
+	if (elapsed > pgm_read_word(&TASKBUDGETS[task])) st->overruns++;
+	next = task + 1;
+	return;
+    }
+} /* task_run() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: task_get_stats
+ *  Purpose	: Get statistics of requested task.
+ *  Method	: Copy data.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+task_get_stats(
+    task_t 		task,	/* task id */
+    taskstats_p		st,	/* statistics */
+    uint16_t		*budget)/* task budget in us */
+{
+    if (task < 0 || task >= TASK_COUNT) return false;
+    *st = taskstats[task];
+    *budget = pgm_read_word(&TASKBUDGETS[task]);
+    return true;
+} /* task_get_stats() */
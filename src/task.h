@@ -0,0 +1,68 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: task.h
+ *  Purpose	: Declarations for background task scheduling.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include <stdint.h>
+
+/*
+ * A list of all background tasks, run from the main loop by task_run().
+ * Each task runs once per period (ms), its first run being delayed by the
+ * phase (ms), so that tasks with equal periods don't run in the same loop
+ * iteration. A task taking longer than its budget (us) is counted as an
+ * overrun. A period of 0 means that the task is always due.
+ */
+/* key		function	 period		    phase	budget	     */
+#define TASK_TABLE							     \
+X(TASK_VDETECT,	max_videodetect, 20,		    0,		500)	     \
+X(TASK_WATCHDOG, max_watchdog,	 100,		    20,		300)	     \
+X(TASK_ALARM,	alarm_task,	 100,		    70,		2000)	     \
+X(TASK_MAHSAVE,	sensor_save_mah, 60000,		    40,		10000)	     \
+X(TASK_FONT,	task_font,	 0,		    0,		20000)	     \
+X(TASK_SENSOR,	sensor_task,	 100,		    10,		2000)	     \
+
+/* X-macro generating task enums. */
+typedef enum task_t {
+#define X(key, func, period, phase, budget) key,
+    TASK_TABLE
+#undef X
+    TASK_COUNT
+} task_t;
+
+typedef struct taskstats_t {	/* task statistics */
+    uint16_t	maxtime;	/* max. execution time in us */
+    uint16_t	overruns;	/* number of budget overruns */
+    uint16_t	maxlate;	/* max. start delay in ms */
+} taskstats_t, *taskstats_p;
+
+void task_setup(void);
+
+void task_run(void);
+
+bool task_get_stats(task_t, taskstats_p, uint16_t *);
+
+#endif /* TASK_H */
@@ -0,0 +1,128 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: tile.cpp
+ *  Purpose	: Character tiles stored in eeprom.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <stdint.h>
+#include "config.h"
+#include "max7456.h"
+#include "tile.h"
+
+
+/*------------------------------------------------------------------------
+ *  Function	: tile_def
+ *  Purpose	: Define a tile.
+ *  Method	: Store size and characters in eeprom.
+ *
+ *  The characters are given row by row, width * height in total. Each
+ *  eeprom write takes a few milliseconds, but unchanged bytes are skipped,
+ *  see cfg_write().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+tile_def(
+    int16_t	id,	/* tile id */
+    int16_t	width,	/* width in characters */
+    int16_t	height,	/* height in characters */
+    int		i,	/* num of bytes processed in earlier calls */
+    int		len,	/* data length in bytes */
+    const char	*data)	/* data to process */
+{
+    uint16_t	addr;	/* eeprom address of tile */
+
+    if (id < 0 || id >= TILE_COUNT) return false;
+    if (width <= 0 || height <= 0 || width > MAXCOLS || height > MAXROWS
+	|| width * height > TILE_CELLS) {
+	return false;
+    }
+    addr = EEPROM_TILE_ADDR + id * EEPROM_TILE_SLOT;
+    if (i == 0) {
+	cfg_write(addr, width);
+	cfg_write(addr + 1, height);
+    }
+    for (int j = 0; j < len; j++) {
+	if (i + j >= width * height) {
+	    return false;	/* too much data */
+	}
+	cfg_write(addr + 2 + i + j, data[j]);
+    }
+    return true;
+} /* tile_def() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: tile_blit
+ *  Purpose	: Show a tile on screen.
+ *  Method	: Use SCREENUPDATEATTR macro for each character.
+ *
+ *  Characters equal to key are skipped, so that what is on screen shows
+ *  through. Parts beyond the screen edges are cut off, so a tile can be
+ *  moved partially off screen.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+tile_blit(
+    int16_t	id,	/* tile id */
+    int16_t	x,	/* x-position of top left */
+    int16_t	y,	/* y-position of top left */
+    int16_t	key,	/* transparent character, or TILE_NOKEY */
+    uint8_t	attr)	/* attributes */
+{
+    uint16_t	addr;	/* eeprom address of characters */
+    uint8_t	width;	/* width in characters */
+    uint8_t	height;	/* height in characters */
+    char	ch;	/* tile character */
+
+    if (id < 0 || id >= TILE_COUNT || key < TILE_NOKEY || key > 0xFF) {
+	return false;
+    }
+    addr = EEPROM_TILE_ADDR + id * EEPROM_TILE_SLOT;
+    width = EEPROM.read(addr);
+    height = EEPROM.read(addr + 1);
+    if (width == 0 || height == 0 || width * height > TILE_CELLS) {
+	return false;	/* undefined, e.g. erased eeprom */
+    }
+    addr += 2;
+    for (int16_t r = 0; r < height; r++) {
+	for (int16_t c = 0; c < width; c++, addr++) {
+	    if (y + r < 0 || y + r >= screenbuf.rows
+		|| x + c < 0 || x + c >= screenbuf.cols) {
+		continue;
+	    }
+	    ch = EEPROM.read(addr);
+	    if (key != TILE_NOKEY && (uint8_t)ch == key) {
+		continue;
+	    }
+	    SCREENUPDATEATTR(screenbuf, (y + r) * screenbuf.cols + x + c,
+			     ch, attr);
+	}
+    }
+    return true;
+} /* tile_blit() */
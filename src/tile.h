@@ -0,0 +1,40 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: tile.h
+ *  Purpose	: Declarations for stored character tiles.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#ifndef TILE_H
+#define TILE_H
+
+#include <stdint.h>
+
+#define TILE_COUNT	(8)	/* number of tiles */
+#define TILE_CELLS	(30)	/* max. characters per tile */
+#define TILE_NOKEY	(-1)	/* no transparent character */
+
+bool tile_def(int16_t, int16_t, int16_t, int, int, const char *);
+
+bool tile_blit(int16_t, int16_t, int16_t, int16_t, uint8_t);
+
+#endif /* TILE_H */
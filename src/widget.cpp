@@ -0,0 +1,377 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: widget.cpp
+ *  Purpose	: On-screen fields formatted by the OSD.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+/* workaround for stdint.h */
+#define __STDC_LIMIT_MACROS
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "max7456.h"
+#include "widget.h"
+
+typedef struct field_t {		/* field definition */
+    int8_t	x;			/* x-position */
+    int8_t	y;			/* y-position */
+    uint8_t	type;			/* FIELD_INT etc. */
+    uint8_t	width;			/* width excluding suffix, 0 if unused */
+    uint8_t	decimals;		/* number of decimals */
+    uint8_t	drawn;			/* number of characters on screen */
+    union {				/* text fields and bars don't share */
+	char	suffix[FIELD_SUFFIX + 1]; /* text after value */
+	struct {
+	    int16_t	min;		/* bar/gauge value at empty */
+	    int16_t	max;		/* bar/gauge value at full */
+	};
+    };
+} field_t, *field_p;
+
+static field_t	fields[FIELD_COUNT];	/* field definitions */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: widget_format
+ *  Purpose	: Format a field value.
+ *  Method	: Collect characters from right to left, right align.
+ *
+ *  Integer math only. A value that doesn't fit is shown as asterisks.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+widget_format(
+    char	*buf,	/* output buffer, at least FIELD_WIDTH + 1 bytes */
+    field_p	field,	/* field definition */
+    int32_t	value)	/* value to format */
+{
+    char	tmp[FIELD_WIDTH + 3];	/* characters in reverse order */
+    uint8_t	n = 0;			/* number of characters */
+    uint8_t	min;			/* min. number of characters */
+    uint32_t	u;			/* absolute value */
+
+    u = value < 0 ? -(uint32_t)value : (uint32_t)value;
+    if (field->type == FIELD_TIME) {
+	if (value < 0) u = 0;
+	tmp[n++] = '0' + u % 10;
+	tmp[n++] = '0' + u / 10 % 6;
+	tmp[n++] = ':';
+	u /= 60;	/* minutes */
+	if (u >= 60 || field->width >= 7) {
+	    tmp[n++] = '0' + u % 10;
+	    tmp[n++] = '0' + u / 10 % 6;
+	    tmp[n++] = ':';
+	    u /= 60;	/* hours */
+	}
+	min = n + 2;	/* two digits for hours or minutes */
+	do {
+	    tmp[n++] = '0' + u % 10;
+	    u /= 10;
+	} while ((u != 0 || n < min) && n <= FIELD_WIDTH);
+    } else {
+	for (uint8_t k = 1; n <= FIELD_WIDTH; k++) {
+	    tmp[n++] = '0' + u % 10;
+	    u /= 10;
+	    if (k == field->decimals) tmp[n++] = '.';
+	    if (u == 0 && k > field->decimals) break;
+	}
+	if (value < 0) {
+	    tmp[n++] = '-';
+	} else if (field->type == FIELD_SIGNED) {
+	    tmp[n++] = '+';
+	}
+    }
+    if (n > field->width) {
+	memset(buf, '*', field->width);
+    } else {
+	memset(buf, ' ', field->width - n);
+	for (uint8_t i = field->width - n; i < field->width; i++) {
+	    buf[i] = tmp[--n];
+	}
+    }
+    buf[field->width] = '\0';
+} /* widget_format() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: widget_formatbar
+ *  Purpose	: Format a bar or gauge value.
+ *  Method	: Scale value to the number of ramp steps, pick glyphs.
+ *
+ *  A bar is filled up to the value, glyph RAMPCHAR being an empty cell and
+ *  RAMPCHAR + RAMPSTEPS a full one, the ones in between partially filled.
+ *  A gauge only shows a full glyph in the cell of the value. Vertical bars
+ *  use ramp VRAMPCHAR, or only empty/full glyphs if that's 0. The buffer
+ *  is filled top down.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+widget_formatbar(
+    char	*buf,	/* output buffer, at least width + 1 bytes */
+    field_p	field,	/* field definition */
+    int32_t	value)	/* value to format */
+{
+    uint8_t	ramp = cfg_get_rampchar();	/* empty glyph */
+    uint8_t	steps = cfg_get_rampsteps();	/* steps per cell */
+    uint8_t	unit = 1;			/* glyph offset per step */
+    uint8_t	len = field->width;		/* number of cells */
+    bool	vertical = (field->type & FIELD_VERTICAL) != 0;
+    int32_t	span = (int32_t)field->max - field->min; /* value range */
+    int32_t	fill;				/* number of steps filled */
+
+    if (vertical) {
+	if (cfg_get_vrampchar() != 0) {
+	    ramp = cfg_get_vrampchar();
+	} else {
+	    unit = steps;	/* whole cells only */
+	    steps = 1;
+	}
+    }
+    if (value < field->min) value = field->min;
+    if (value > field->max) value = field->max;
+    value -= field->min;
+    if ((field->type & ~FIELD_VERTICAL) == FIELD_GAUGE) {
+	fill = span == 0 ? 0 : (value * (len - 1) * 2 + span) / (2 * span);
+	for (uint8_t i = 0; i < len; i++) {
+	    buf[vertical ? len - 1 - i : i] =
+		ramp + (i == fill ? steps * unit : 0);
+	}
+    } else {
+	fill = span == 0 ? 0 : (value * len * steps * 2 + span) / (2 * span);
+	for (uint8_t i = 0; i < len; i++, fill -= fill < steps ? fill : steps) {
+	    buf[vertical ? len - 1 - i : i] =
+		ramp + (fill < steps ? fill : steps) * unit;
+	}
+    }
+    buf[len] = '\0';
+} /* widget_formatbar() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: widget_draw
+ *  Purpose	: Draw text of a field.
+ *  Method	: Only set characters that differ, clear what was drawn
+ *  		  before beyond the new text.
+ *
+ *  The text gets the given attributes, cleared characters normal ones.
+ *  Vertical bars and gauges are drawn top down.
+ *
+ *  Returns	: Nothing.
+ *------------------------------------------------------------------------
+ */
+static void
+widget_draw(
+    field_p	field,	/* field definition */
+    const char	*str,	/* text to draw */
+    uint8_t	attr)	/* attributes of text */
+{
+    uint8_t	len = strlen(str);	/* text length */
+    uint8_t	x = field->x;		/* x-position */
+    uint8_t	y = field->y;		/* y-position */
+
+    for (uint8_t i = 0; i < len || i < field->drawn; i++) {
+	if (x >= screenbuf.cols || y >= screenbuf.rows) break;
+	if (i < len) {
+	    SCREENUPDATEATTR(screenbuf, y * screenbuf.cols + x, str[i], attr);
+	} else {
+	    SCREENUPDATE(screenbuf, y * screenbuf.cols + x, 0x00);
+	}
+	if ((field->type & FIELD_VERTICAL) != 0) {
+	    y++;
+	} else {
+	    x++;
+	}
+    }
+    field->drawn = len;
+} /* widget_draw() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: widget_def
+ *  Purpose	: Define a field.
+ *  Method	: Decode format, clear field drawn before.
+ *
+ *  The format is a number: type * 100 + width * 10 + decimals, e.g. 52
+ *  for a width of 5 with 2 decimals and 280 for hh:mm:ss. A width of 0
+ *  removes the field. The suffix is cleared, see widget_suffix().
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+widget_def(
+    int16_t	id,	/* field id */
+    int16_t	x,	/* x-position */
+    int16_t	y,	/* y-position */
+    int16_t	format)	/* type, width and decimals */
+{
+    field_p	field;	/* field definition */
+    uint8_t	type;	/* field type */
+    uint8_t	width;	/* field width */
+    uint8_t	decimals;/* number of decimals */
+
+    if (id < 0 || id >= FIELD_COUNT || format < 0) return false;
+    if (x < 0 || y < 0 || x >= MAXCOLS || y >= MAXROWS) return false;
+    type = format / 100;
+    width = format / 10 % 10;
+    decimals = format % 10;
+    if (type > FIELD_TIME || (width > 0 && decimals >= width)) return false;
+    if (type == FIELD_TIME && decimals != 0) return false;
+    field = &fields[id];
+    widget_draw(field, "", ATTR_NORMAL);
+    field->x = x;
+    field->y = y;
+    field->type = type;
+    field->width = width;
+    field->decimals = decimals;
+    field->suffix[0] = '\0';
+    return true;
+} /* widget_def() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: widget_suffix
+ *  Purpose	: Set the text after the value of a field.
+ *  Method	: Copy data, silently truncate at FIELD_SUFFIX characters.
+ *
+ *  The new suffix shows up with the next value.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+widget_suffix(
+    int16_t	id,	/* field id */
+    int		i,	/* num of bytes processed in earlier calls */
+    int		len,	/* data length in bytes */
+    const char	*data)	/* data to process */
+{
+    field_p	field;	/* field definition */
+
+    if (id < 0 || id >= FIELD_COUNT || fields[id].width == 0) return false;
+    field = &fields[id];
+    if ((field->type & ~FIELD_VERTICAL) >= FIELD_BAR) return false;
+    for (int j = 0; j < len && i + j < FIELD_SUFFIX; j++) {
+	field->suffix[i + j] = data[j];
+	field->suffix[i + j + 1] = '\0';
+    }
+    return true;
+} /* widget_suffix() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: widget_set
+ *  Purpose	: Show a new value in a field.
+ *  Method	: Format value, append suffix if any, draw.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+widget_set(
+    int16_t	id,	/* field id */
+    int32_t	value,	/* value to show */
+    uint8_t	attr)	/* attributes */
+{
+    field_p	field;	/* field definition */
+    char	buf[MAXCOLS + 1];	/* text */
+
+    if (id < 0 || id >= FIELD_COUNT || fields[id].width == 0) return false;
+    field = &fields[id];
+    if ((field->type & ~FIELD_VERTICAL) >= FIELD_BAR) {
+	widget_formatbar(buf, field, value);
+    } else {
+	widget_format(buf, field, value);
+	strcat(buf, field->suffix);
+    }
+    widget_draw(field, buf, attr);
+    return true;
+} /* widget_set() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: widget_defbar
+ *  Purpose	: Define a bar or gauge.
+ *  Method	: Clear field drawn before, store definition.
+ *
+ *  A positive length runs to the right, a negative length runs upwards
+ *  from the bottom, with x and y being the top left position. The value
+ *  range is reset to 0 - 100, see widget_range(). A length of 0 removes
+ *  the field.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+widget_defbar(
+    int16_t	id,	/* field id */
+    int16_t	x,	/* x-position */
+    int16_t	y,	/* y-position */
+    int16_t	len,	/* length in cells, negative for vertical */
+    uint8_t	type)	/* FIELD_BAR or FIELD_GAUGE */
+{
+    field_p	field;	/* field definition */
+
+    if (id < 0 || id >= FIELD_COUNT) return false;
+    if (x < 0 || y < 0 || x >= MAXCOLS || y >= MAXROWS) return false;
+    if (len > MAXCOLS || len < -MAXROWS) return false;
+    field = &fields[id];
+    widget_draw(field, "", ATTR_NORMAL);
+    field->x = x;
+    field->y = y;
+    field->type = len < 0 ? type | FIELD_VERTICAL : type;
+    field->width = len < 0 ? -len : len;
+    field->decimals = 0;
+    field->min = 0;
+    field->max = 100;
+    return true;
+} /* widget_defbar() */
+
+
+/*------------------------------------------------------------------------
+ *  Function	: widget_range
+ *  Purpose	: Set the value range of a bar or gauge.
+ *  Method	: Store range.
+ *
+ *  Returns	: Indication of success.
+ *------------------------------------------------------------------------
+ */
+bool
+widget_range(
+    int16_t	id,	/* field id */
+    int32_t	min,	/* value at empty */
+    int32_t	max)	/* value at full */
+{
+    if (id < 0 || id >= FIELD_COUNT || fields[id].width == 0) return false;
+    if ((fields[id].type & ~FIELD_VERTICAL) < FIELD_BAR) return false;
+    if (min >= max || min < INT16_MIN || max > INT16_MAX) return false;
+    fields[id].min = min;
+    fields[id].max = max;
+    return true;
+} /* widget_range() */
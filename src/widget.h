@@ -0,0 +1,54 @@
+/*========================================================================
+ *  Copyright (c) 2026 Martin7182
+ *
+ *  This file is part of GSOSD.
+ *
+ *  GSOSD is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  GSOSD is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GSOSD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  File	: widget.h
+ *  Purpose	: Declarations for on-screen fields.
+ *  Author(s)	: Martin7182
+ *  Creation	: 2026/10/19
+ *
+ *========================================================================
+ */
+
+#ifndef WIDGET_H
+#define WIDGET_H
+
+#include <stdint.h>
+
+#define FIELD_COUNT	(8)	/* number of fields */
+#define FIELD_WIDTH	(9)	/* max. field width, excluding suffix */
+#define FIELD_SUFFIX	(4)	/* max. suffix length */
+
+/* Field types, see widget_def(). */
+#define FIELD_INT	(0)	/* integer, sign only when negative */
+#define FIELD_SIGNED	(1)	/* integer, always with sign */
+#define FIELD_TIME	(2)	/* time in seconds as [h:]mm:ss */
+#define FIELD_BAR	(3)	/* bar filled up to value */
+#define FIELD_GAUGE	(4)	/* scale with marker at value */
+#define FIELD_VERTICAL	(0x80)	/* bar or gauge from bottom to top */
+
+bool widget_def(int16_t, int16_t, int16_t, int16_t);
+
+bool widget_suffix(int16_t, int, int, const char *);
+
+bool widget_set(int16_t, int32_t, uint8_t);
+
+bool widget_defbar(int16_t, int16_t, int16_t, int16_t, uint8_t);
+
+bool widget_range(int16_t, int32_t, int32_t);
+
+#endif /* WIDGET_H */